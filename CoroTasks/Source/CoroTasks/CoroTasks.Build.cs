@@ -4,15 +4,39 @@ using UnrealBuildTool;
 
 public class CoroTasks : ModuleRules
 {
+	// Set to false to build CoroTasks with exceptions disabled
+	public static bool bUseExceptions = true;
+
+	// Set to true to track all live tasks and futures (CoroTasks.List, CoroTasks.Graph, stat CoroTasks)
+	public static bool bWithRegistry = false;
+
+	// Set to true to measure suspend-to-resume time of every co_await site (CoroTasks.TrackAwaitLatency), ignored in Shipping
+	public static bool bWithAwaitLatency = false;
+
+	// Set to true to count live coroutine frames (peak live frames of the CoroTasksStress commandlet), ignored in Shipping
+	public static bool bWithFrameStats = false;
+
 	public CoroTasks(ReadOnlyTargetRules Target) : base(Target)
 	{
 		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
 
 		CppStandard = CppStandardVersion.Cpp20;
+
+		// Without exceptions tasks report failures through FCoroError/TCoroResult (see CoroError.h),
+		// which removes unwind tables and exception_ptr from every coroutine
+		bEnableExceptions = bUseExceptions;
+		PublicDefinitions.Add("COROTASKS_WITH_EXCEPTIONS=" + (bUseExceptions ? "1" : "0"));
+		PublicDefinitions.Add("COROTASKS_WITH_REGISTRY=" + (bWithRegistry ? "1" : "0"));
+		bool bAwaitLatency = bWithAwaitLatency && Target.Configuration != UnrealTargetConfiguration.Shipping;
+		PublicDefinitions.Add("COROTASKS_WITH_AWAIT_LATENCY=" + (bAwaitLatency ? "1" : "0"));
+		bool bFrameStats = bWithFrameStats && Target.Configuration != UnrealTargetConfiguration.Shipping;
+		PublicDefinitions.Add("COROTASKS_FRAME_STATS=" + (bFrameStats ? "1" : "0"));
 		
 		
 		PublicIncludePaths.AddRange(
 			new string[] {
+				// Engine-independent core, it's also built by CoroTasks/Standalone
+				System.IO.Path.Combine(ModuleDirectory, "Public", "Core"),
 				// ... add public include paths required here ...
 			}
 			);
@@ -30,6 +54,9 @@ public class CoroTasks : ModuleRules
 			{
 				"Core", 
 				"GameplayAbilities",
+				"GameplayTags",
+				"NavigationSystem",
+				"AIModule",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -44,6 +71,7 @@ public class CoroTasks : ModuleRules
 				"SlateCore",
 				"GameplayTasks",
 				"DeveloperSettings",
+				"Json",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
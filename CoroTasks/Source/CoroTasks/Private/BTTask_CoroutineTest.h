@@ -1,4 +1,4 @@
-﻿// Copyright (c) 2023, Artem Selivanov
+// Copyright (c) 2023, Artem Selivanov
 // 
 // Redistribution and use in source and binary forms, with or without
 // modification, are permitted provided that the following conditions are met:
@@ -21,46 +21,27 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-#include "Coroutine.h"
-#include "CoroTask.h"
-#include "CoroFuture.h"
+#pragma once
 
-using namespace CoroTasks;
+#include "CoreMinimal.h"
+#include "AsyncSync.h"
+#include "BTTask_Coroutine.h"
+#include "BTTask_CoroutineTest.generated.h"
 
-#if WITH_CPP_COROUTINES
-
-FFuture_Base::FFuture_Base()
-	: bResultIsSet(false)
-{
-	Exception = nullptr;
-	bResumed = false;
-	bWasSuspended = false;
-}
-
-FFuture_Base::~FFuture_Base()
-{
-
-}
-
-bool FFuture_Base::ShouldResume() const
+/** Node of CoroTasks.BTTask_Coroutine test: completes right away, or after Gate is triggered when the test sets it */
+UCLASS(NotBlueprintable, HideDropdown)
+class UBTTask_CoroutineTest : public UBTTask_Coroutine
 {
-	if (HasResult.IsBound())
-		return HasResult.Execute();
-	return false;
-}
+	GENERATED_BODY()
 
-void FFuture_Base::ThrowIfException() const
-{
-	if (Exception)
-	{
-		std::rethrow_exception(Exception);
-	}
-}
+public:
+	CoroTasks::FAsyncEvent* Gate = nullptr;
+	EBTNodeResult::Type Result = EBTNodeResult::Succeeded;
 
-void FFuture_Base::SetException(std::exception_ptr ExcPtr)
-{
-	Exception = ExcPtr;
-	CoroutineHandle.resume();
-}
+	int32 NumStarted = 0;
+	int32 NumFinished = 0;
+	int32 NumDestroyed = 0;
 
-#endif
\ No newline at end of file
+protected:
+	virtual CoroTasks::TTask<EBTNodeResult::Type> ExecuteCoroutine(UBehaviorTreeComponent& OwnerComp) override;
+};
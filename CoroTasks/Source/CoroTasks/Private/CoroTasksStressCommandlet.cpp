@@ -0,0 +1,431 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroTasksStressCommandlet.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "CoroCountingMalloc.h"
+#include "CoroFramePool.h"
+#include "CoroScheduler.h"
+#include "CoroTask.h"
+#include "CoroTasks.h"
+#include "CoroTasksTestsSettings.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "LoadAsset.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace
+{
+	constexpr float StressDeltaTime = 1.f / 60.f;
+	constexpr int32 RecursionChains = 100;
+
+	struct FStressSettings
+	{
+		int32 Count = 0;
+		int32 DelayFrames = 0;
+		int32 ComputeIterations = 0;
+		int32 RecursionDepth = 0;
+		int32 MaxFrames = 0;
+		TSoftObjectPtr<UObject> ObjectToLoad;
+		TSubclassOf<AActor> ActorClass;
+	};
+
+	struct FStressResult
+	{
+		FString Name;
+		int32 Coroutines = 0;
+		int32 Frames = 0;
+		bool bFinished = false;
+		double TotalMs = 0.0;
+		double FrameMsP50 = 0.0;
+		double FrameMsP99 = 0.0;
+		int64 PeakLiveFrames = 0;
+		uint64 BytesAllocated = 0;
+		uint64 Allocations = 0;
+		double CoroutinesPerSecond = 0.0;
+	};
+
+	/** Frame counter of the stress loop. Coroutines wait for frames without polling delegates */
+	class FStressFrameClock
+	{
+	public:
+		struct FAwaiter
+		{
+			FStressFrameClock& Clock;
+			uint64 TargetFrame;
+
+			bool await_ready() const
+			{
+				return Clock.Frame >= TargetFrame;
+			}
+
+			void await_suspend(std::coroutine_handle<> Handle)
+			{
+				Clock.Waiting.Add({TargetFrame, CoroTasks::FContinuation::Capture(Handle, TEXT("FStressFrameClock"))});
+			}
+
+			void await_resume()
+			{
+			}
+		};
+
+		FAwaiter WaitFrames(int32 Count)
+		{
+			return {*this, Frame + Count};
+		}
+
+		/** Resumed coroutines may wait again, so ready ones are taken out before resuming */
+		void Advance()
+		{
+			++Frame;
+			TArray<FWaiter> Ready;
+			TArray<FWaiter> Pending = MoveTemp(Waiting);
+			for (FWaiter& Waiter : Pending)
+			{
+				if (Waiter.TargetFrame <= Frame)
+					Ready.Add(MoveTemp(Waiter));
+				else
+					Waiting.Add(MoveTemp(Waiter));
+			}
+			for (const FWaiter& Waiter : Ready)
+				Waiter.Continuation.Resume();
+		}
+
+		/** Forgets every wait, call after the waiting coroutines are cancelled */
+		void Reset()
+		{
+			Waiting.Reset();
+		}
+
+	private:
+		struct FWaiter
+		{
+			uint64 TargetFrame;
+			CoroTasks::FContinuation Continuation;
+		};
+
+		uint64 Frame = 0;
+		TArray<FWaiter> Waiting;
+	};
+
+	double Percentile(TArray<double> Values, double Fraction)
+	{
+		if (Values.Num() == 0)
+			return 0.0;
+		Values.Sort();
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Values.Num()) - 1, 0, Values.Num() - 1);
+		return Values[Index];
+	}
+
+	/** Runs frames of the headless loop and measures them. GMalloc is swapped for the lifetime of the runner */
+	class FStressRunner
+	{
+	public:
+		FStressRunner(UWorld* InWorld, int32 InMaxFrames)
+			: World(InWorld)
+			, MaxFrames(InMaxFrames)
+			, OriginalMalloc(GMalloc)
+		{
+			// Proxy is never freed: other threads may still be inside of it
+			static CoroTasks::FCountingMalloc* CountingMalloc = new CoroTasks::FCountingMalloc(GMalloc);
+			Counting = CountingMalloc;
+			GMalloc = Counting;
+		}
+
+		~FStressRunner()
+		{
+			GMalloc = OriginalMalloc;
+		}
+
+		/** OnFrame is called at the beginning of each frame (launches on the frame 0), scenario ends when IsFinished is true */
+		FStressResult Run(const FString& Name, int32 NumCoroutines, TFunctionRef<void(int32)> OnFrame, TFunctionRef<bool()> IsFinished)
+		{
+			FStressResult Result;
+			Result.Name = Name;
+			Result.Coroutines = NumCoroutines;
+
+			TArray<double> FrameMs;
+			FrameMs.Reserve(MaxFrames);
+			CoroTasks::FCoroFramePool::ResetPeakLiveFrames();
+			Counting->Begin();
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			while (FrameMs.Num() < MaxFrames && !Result.bFinished)
+			{
+				const uint64 FrameStartCycles = FPlatformTime::Cycles64();
+				OnFrame(FrameMs.Num());
+				Tick();
+				FrameMs.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - FrameStartCycles));
+				Result.bFinished = IsFinished();
+			}
+			const uint64 TotalCycles = FPlatformTime::Cycles64() - StartCycles;
+			Result.Allocations = Counting->End();
+			Result.BytesAllocated = Counting->GetNumBytes();
+
+			Result.Frames = FrameMs.Num();
+			Result.TotalMs = FPlatformTime::ToMilliseconds64(TotalCycles);
+			Result.FrameMsP50 = Percentile(FrameMs, 0.5);
+			Result.FrameMsP99 = Percentile(FrameMs, 0.99);
+			Result.PeakLiveFrames = CoroTasks::FCoroFramePool::GetPeakLiveFrames();
+			Result.CoroutinesPerSecond = Result.TotalMs > 0.0 ? NumCoroutines * 1000.0 / Result.TotalMs : 0.0;
+			return Result;
+		}
+
+		FStressFrameClock Clock;
+
+	private:
+		void Tick()
+		{
+			Clock.Advance();
+			FTSTicker::GetCoreTicker().Tick(StressDeltaTime);
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			if (IsAsyncLoading())
+				ProcessAsyncLoading(true, false, 0.005f);
+			World->Tick(LEVELTICK_All, StressDeltaTime);
+		}
+
+		UWorld* World;
+		int32 MaxFrames;
+		FMalloc* OriginalMalloc;
+		CoroTasks::FCountingMalloc* Counting;
+	};
+
+	/** Delay -> load -> compute -> spawn */
+	CoroTasks::TTask<> Stress_Pipeline(FStressFrameClock& Clock, const FStressSettings& Settings, TWeakObjectPtr<UWorld> World, int32& NumFinished)
+	{
+		co_await Clock.WaitFrames(Settings.DelayFrames);
+
+		uint32 Hash = 0;
+		if (!Settings.ObjectToLoad.IsNull())
+		{
+			const UObject* Object = co_await CoroTasks::LoadSingleObject(Settings.ObjectToLoad);
+			Hash = GetTypeHash(Object);
+		}
+
+		for (int32 Index = 0; Index < Settings.ComputeIterations; ++Index)
+			Hash = HashCombine(Hash, GetTypeHash(Index));
+
+		if (UWorld* SpawnWorld = World.Get())
+		{
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.ObjectFlags |= RF_Transient;
+			SpawnWorld->SpawnActor<AActor>(Settings.ActorClass, FTransform(FVector((double)(Hash % 1024), 0.0, 0.0)), SpawnParameters);
+		}
+		++NumFinished;
+	}
+
+	/** Never resumed, counts its destruction by cancel */
+	CoroTasks::TTask<> Stress_Parked(FStressFrameClock& Clock, int32& NumCancelled)
+	{
+		ON_SCOPE_EXIT { ++NumCancelled; };
+		co_await Clock.WaitFrames(MAX_int32);
+	}
+
+	CoroTasks::TTask<int32> Stress_Recursion(int32 Depth)
+	{
+		if (Depth == 0)
+			co_return 0;
+		CORO_TRY(Value, Stress_Recursion(Depth - 1));
+		co_return Value + 1;
+	}
+
+	CoroTasks::TTask<> Stress_RecursionRoot(int32 Depth, int32& NumFinished)
+	{
+		CORO_TRY(Value, Stress_Recursion(Depth));
+		if (Value == Depth)
+			++NumFinished;
+	}
+
+	/** Coroutines of a STUCK scenario reference its locals: they are destroyed before the scenario ends and the clock forgets them */
+	void CancelPending(TArray<CoroTasks::TTask<>>& Tasks, FStressFrameClock& Clock)
+	{
+		for (CoroTasks::TTask<>& Task : Tasks)
+		{
+			if (!Task.IsDone())
+				Task.Cancel();
+		}
+		Tasks.Reset();
+		Clock.Reset();
+	}
+
+	TSharedRef<FJsonObject> ToJson(const FStressResult& Result)
+	{
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("Name"), Result.Name);
+		Object->SetNumberField(TEXT("Coroutines"), Result.Coroutines);
+		Object->SetNumberField(TEXT("Frames"), Result.Frames);
+		Object->SetBoolField(TEXT("Finished"), Result.bFinished);
+		Object->SetNumberField(TEXT("TotalMs"), Result.TotalMs);
+		Object->SetNumberField(TEXT("FrameMsP50"), Result.FrameMsP50);
+		Object->SetNumberField(TEXT("FrameMsP99"), Result.FrameMsP99);
+		Object->SetNumberField(TEXT("PeakLiveFrames"), Result.PeakLiveFrames);
+		Object->SetNumberField(TEXT("BytesAllocated"), Result.BytesAllocated);
+		Object->SetNumberField(TEXT("Allocations"), Result.Allocations);
+		Object->SetNumberField(TEXT("CoroutinesPerSecond"), Result.CoroutinesPerSecond);
+		return Object;
+	}
+
+	FString ToCsv(const TArray<FStressResult>& Results)
+	{
+		FString Csv = TEXT("Name,Coroutines,Frames,Finished,TotalMs,FrameMsP50,FrameMsP99,PeakLiveFrames,BytesAllocated,Allocations,CoroutinesPerSecond\n");
+		for (const FStressResult& Result : Results)
+		{
+			Csv += FString::Printf(TEXT("%s,%d,%d,%d,%.3f,%.3f,%.3f,%lld,%llu,%llu,%.1f\n"),
+				*Result.Name, Result.Coroutines, Result.Frames, Result.bFinished ? 1 : 0, Result.TotalMs,
+				Result.FrameMsP50, Result.FrameMsP99, Result.PeakLiveFrames, Result.BytesAllocated, Result.Allocations,
+				Result.CoroutinesPerSecond);
+		}
+		return Csv;
+	}
+}
+
+UCoroTasksStressCommandlet::UCoroTasksStressCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UCoroTasksStressCommandlet::Main(const FString& Params)
+{
+	const UCoroTasksTestsSettings* TestsSettings = GetDefault<UCoroTasksTestsSettings>();
+	FStressSettings Settings;
+	Settings.Count = TestsSettings->StressCoroutineCount;
+	Settings.DelayFrames = TestsSettings->StressDelayFrames;
+	Settings.ComputeIterations = TestsSettings->StressComputeIterations;
+	Settings.RecursionDepth = TestsSettings->StressRecursionDepth;
+	Settings.MaxFrames = TestsSettings->StressMaxFrames;
+	Settings.ObjectToLoad = TestsSettings->TestObjectToLoad;
+	Settings.ActorClass = TestsSettings->StressActorClass.IsNull() ? AActor::StaticClass() : TestsSettings->StressActorClass.LoadSynchronous();
+
+	FParse::Value(*Params, TEXT("Count="), Settings.Count);
+	FParse::Value(*Params, TEXT("Depth="), Settings.RecursionDepth);
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Stress") / TEXT("CoroTasksStress.json");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+#if !COROTASKS_FRAME_STATS
+	UE_LOG(LogCoroTasks, Warning, TEXT("Frame stats are compiled out, peak live frames are reported as zero (set bWithFrameStats in CoroTasks.Build.cs)"));
+#endif
+
+	if (!Settings.ActorClass)
+	{
+		UE_LOG(LogCoroTasks, Error, TEXT("Can't load StressActorClass %s"), *TestsSettings->StressActorClass.ToString());
+		return 1;
+	}
+	if (Settings.ObjectToLoad.IsNull())
+		UE_LOG(LogCoroTasks, Warning, TEXT("TestObjectToLoad is not set, Pipeline scenario skips loading"));
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CoroTasksStress"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	TArray<FStressResult> Results;
+	{
+		FStressRunner Runner(World, Settings.MaxFrames);
+
+		TArray<CoroTasks::TTask<>> Tasks;
+		Tasks.Reserve(Settings.Count);
+
+		int32 NumFinished = 0;
+		Results.Add(Runner.Run(TEXT("Pipeline"), Settings.Count,
+			[&] (int32 Frame)
+			{
+				if (Frame == 0)
+				{
+					for (int32 Index = 0; Index < Settings.Count; ++Index)
+						Tasks.Add_GetRef(Stress_Pipeline(Runner.Clock, Settings, World, NumFinished)).Launch();
+				}
+			},
+			[&] { return NumFinished == Settings.Count; }));
+		CancelPending(Tasks, Runner.Clock);
+
+		// Coroutines parked on the clock, destroyed by TTask::Cancel on the next frame
+		NumFinished = 0;
+		Results.Add(Runner.Run(TEXT("MassCancellation"), Settings.Count,
+			[&] (int32 Frame)
+			{
+				if (Frame == 0)
+				{
+					for (int32 Index = 0; Index < Settings.Count; ++Index)
+						Tasks.Add_GetRef(Stress_Parked(Runner.Clock, NumFinished)).Launch();
+				}
+				else if (Frame == 1)
+				{
+					for (CoroTasks::TTask<>& Task : Tasks)
+						Task.Cancel();
+					Runner.Clock.Reset();
+				}
+			},
+			[&] { return NumFinished == Settings.Count; }));
+		CancelPending(Tasks, Runner.Clock);
+
+		NumFinished = 0;
+		Results.Add(Runner.Run(TEXT("DeepRecursion"), Settings.RecursionDepth * RecursionChains,
+			[&] (int32 Frame)
+			{
+				if (Frame < RecursionChains)
+					Stress_RecursionRoot(Settings.RecursionDepth, NumFinished).Launch();
+			},
+			[&] { return NumFinished == RecursionChains; }));
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	bool bAllFinished = true;
+	TArray<TSharedPtr<FJsonValue>> Scenarios;
+	for (const FStressResult& Result : Results)
+	{
+		UE_LOG(LogCoroTasks, Display, TEXT("%-18s %s %8d coroutines %6d frames  p50 %8.3f ms  p99 %8.3f ms  peak %8lld frames  %12llu bytes  %12.1f coroutines/s"),
+			*Result.Name, Result.bFinished ? TEXT("    ") : TEXT("STUCK"), Result.Coroutines, Result.Frames, Result.FrameMsP50, Result.FrameMsP99,
+			Result.PeakLiveFrames, Result.BytesAllocated, Result.CoroutinesPerSecond);
+		bAllFinished &= Result.bFinished;
+		Scenarios.Add(MakeShared<FJsonValueObject>(ToJson(Result)));
+	}
+
+	FString Output;
+	if (FPaths::GetExtension(OutputPath) == TEXT("csv"))
+	{
+		Output = ToCsv(Results);
+	}
+	else
+	{
+		TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetArrayField(TEXT("Scenarios"), Scenarios);
+		FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Output));
+	}
+
+	if (!FFileHelper::SaveStringToFile(Output, *OutputPath))
+	{
+		UE_LOG(LogCoroTasks, Error, TEXT("Can't write %s"), *OutputPath);
+		return 1;
+	}
+	UE_LOG(LogCoroTasks, Display, TEXT("Results are written to %s"), *OutputPath);
+	return bAllFinished ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AbilitySystemComponent.h"
+#include "AsyncAbilitySystem.h"
+#include "CoroTask.h"
+#include "NativeGameplayTags.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_AsyncAbilitySystem, "CoroTasks.AsyncAbilitySystem",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_CoroTasksTest_Event, "CoroTasksTest.Event");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_CoroTasksTest_Event_Child, "CoroTasksTest.Event.Child");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_CoroTasksTest_State, "CoroTasksTest.State");
+
+CoroTasks::TTask<> Task_WaitEvent(UAbilitySystemComponent* AbilitySystem, float& OutMagnitude)
+{
+	const FGameplayEventData Payload = co_await CoroTasks::WaitGameplayEvent(AbilitySystem, TAG_CoroTasksTest_Event);
+	OutMagnitude = Payload.EventMagnitude;
+}
+
+CoroTasks::TTask<> Task_WaitEventTwice(UAbilitySystemComponent* AbilitySystem, int32& NumEvents)
+{
+	co_await CoroTasks::WaitGameplayEvent(AbilitySystem, TAG_CoroTasksTest_Event);
+	++NumEvents;
+	co_await CoroTasks::WaitGameplayEvent(AbilitySystem, TAG_CoroTasksTest_Event);
+	++NumEvents;
+}
+
+CoroTasks::TTask<> Task_WaitStateCycle(UAbilitySystemComponent* AbilitySystem, TArray<int32>& Order)
+{
+	co_await CoroTasks::WaitTagAdded(AbilitySystem, TAG_CoroTasksTest_State);
+	Order.Add(1);
+	co_await CoroTasks::WaitTagRemoved(AbilitySystem, TAG_CoroTasksTest_State);
+	Order.Add(2);
+}
+
+bool Test_AsyncAbilitySystem::RunTest(const FString& Parameters)
+{
+	UAbilitySystemComponent* AbilitySystem = NewObject<UAbilitySystemComponent>(GetTransientPackage());
+
+	{
+		float Magnitude = 0.f;
+		auto Task = Task_WaitEvent(AbilitySystem, Magnitude);
+		Task.Launch();
+		TestFalse(TEXT("Event is not sent yet"), Task.IsDone());
+
+		FGameplayEventData Payload;
+		Payload.EventMagnitude = 5.f;
+		AbilitySystem->HandleGameplayEvent(TAG_CoroTasksTest_Event_Child, &Payload);
+		TestTrue(TEXT("Child event tag resumes parent tag wait"), Task.IsDone());
+		TestEqual(TEXT("Payload is delivered"), Magnitude, 5.f);
+
+		Payload.EventMagnitude = 7.f;
+		AbilitySystem->HandleGameplayEvent(TAG_CoroTasksTest_Event, &Payload);
+		TestEqual(TEXT("Event after resume reaches nobody"), Magnitude, 5.f);
+	}
+
+	{
+		int32 NumEvents = 0;
+		auto Task = Task_WaitEventTwice(AbilitySystem, NumEvents);
+		Task.Launch();
+
+		FGameplayEventData Payload;
+		AbilitySystem->HandleGameplayEvent(TAG_CoroTasksTest_Event, &Payload);
+		TestEqual(TEXT("Wait started during broadcast misses that event"), NumEvents, 1);
+		AbilitySystem->HandleGameplayEvent(TAG_CoroTasksTest_Event, &Payload);
+		TestEqual(TEXT("Next event resumes the second wait"), NumEvents, 2);
+		TestTrue(TEXT("Task is done"), Task.IsDone());
+	}
+
+	{
+		TArray<int32> Order;
+		auto Task = Task_WaitStateCycle(AbilitySystem, Order);
+		Task.Launch();
+		TestTrue(TEXT("Tag is absent, nothing happens"), Order.IsEmpty());
+
+		AbilitySystem->AddLooseGameplayTag(TAG_CoroTasksTest_State);
+		AbilitySystem->AddLooseGameplayTag(TAG_CoroTasksTest_State);
+		TestEqual(TEXT("Tag added resumes once"), Order, TArray<int32>{1});
+
+		AbilitySystem->RemoveLooseGameplayTag(TAG_CoroTasksTest_State);
+		TestEqual(TEXT("Tag is still present with count 1"), Order, TArray<int32>{1});
+		AbilitySystem->RemoveLooseGameplayTag(TAG_CoroTasksTest_State);
+		TestEqual(TEXT("Tag removal resumes"), Order, TArray<int32>{1, 2});
+		TestTrue(TEXT("Task is done"), Task.IsDone());
+
+		AbilitySystem->AddLooseGameplayTag(TAG_CoroTasksTest_State);
+		Order.Reset();
+		auto ReadyTask = Task_WaitStateCycle(AbilitySystem, Order);
+		ReadyTask.Launch();
+		TestEqual(TEXT("Present tag doesn't suspend"), Order, TArray<int32>{1});
+		AbilitySystem->RemoveLooseGameplayTag(TAG_CoroTasksTest_State);
+		TestTrue(TEXT("Second task is done"), ReadyTask.IsDone());
+	}
+	return true;
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncChannel.h"
+#include "CoroTask.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_AsyncChannel, "CoroTasks.AsyncChannel",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_AsyncChannelThroughput, "CoroTasks.Perf.AsyncChannelThroughput",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+CoroTasks::TTask<> Task_ChannelProducer(CoroTasks::TAsyncChannel<int32>& Channel, int32 Count, bool bClose)
+{
+	for (int32 Value = 1; Value <= Count; ++Value)
+		co_await Channel.Send(Value);
+	if (bClose)
+		Channel.Close();
+}
+
+CoroTasks::TTask<> Task_ChannelConsumer(CoroTasks::TAsyncChannel<int32>& Channel, TArray<int32>& Received)
+{
+	while (TOptional<int32> Value = co_await Channel.Receive())
+		Received.Add(*Value);
+}
+
+bool Test_AsyncChannel::RunTest(const FString& Parameters)
+{
+	CoroTasks::TAsyncChannel<int32> Channel(2);
+	TArray<int32> Received;
+
+	Task_ChannelProducer(Channel, 5, true).Launch();
+	TestFalse(TEXT("Producer is suspended by full channel"), Channel.IsClosed());
+
+	Task_ChannelConsumer(Channel, Received).Launch();
+	TestEqual(TEXT("All values are received in order"), Received, TArray<int32>{1, 2, 3, 4, 5});
+	TestTrue(TEXT("Channel is closed"), Channel.IsClosed());
+
+	CoroTasks::TAsyncChannel<int32> Bounded(3);
+	TestEqual(TEXT("Capacity isn't rounded up"), Bounded.GetCapacity(), 3u);
+	for (int32 Value = 1; Value <= 3; ++Value)
+		TestTrue(TEXT("Send fits into capacity"), Bounded.TrySend(Value));
+	TestFalse(TEXT("Send over capacity fails"), Bounded.TrySend(4));
+	TestEqual(TEXT("Buffered values"), Bounded.Num(), 3u);
+
+	// Senders parked on the full channel deliver before the ones that come later
+	TArray<int32> Ordered;
+	Task_ChannelProducer(Bounded, 2, false).Launch();
+	Task_ChannelProducer(Bounded, 1, false).Launch();
+	Task_ChannelConsumer(Bounded, Ordered).Launch();
+	Bounded.Close();
+	TestEqual(TEXT("Parked senders keep order"), Ordered, TArray<int32>{1, 2, 3, 1, 1, 2});
+
+	CoroTasks::TAsyncChannel<int32> Single(1);
+	TestTrue(TEXT("Single slot takes a value"), Single.TrySend(1));
+	TestFalse(TEXT("Single slot is full"), Single.TrySend(2));
+	TestEqual(TEXT("Single slot value"), Single.TryReceive(), TOptional<int32>(1));
+	TestFalse(TEXT("Single slot is drained"), Single.TryReceive().IsSet());
+
+	// Second send parks until the first value is taken
+	Task_ChannelProducer(Single, 2, true).Launch();
+	TestEqual(TEXT("First of two sends"), Single.TryReceive(), TOptional<int32>(1));
+	TestEqual(TEXT("Second of two sends"), Single.TryReceive(), TOptional<int32>(2));
+	TestFalse(TEXT("Nothing is left after two sends"), Single.TryReceive().IsSet());
+	TestTrue(TEXT("Producer finished"), Single.IsClosed());
+
+	// Cancelled waiters leave the channel
+	CoroTasks::TAsyncChannel<int32> Cancelling(1);
+	TArray<int32> Unused;
+	CoroTasks::TTask<> Receiver = Task_ChannelConsumer(Cancelling, Unused);
+	Receiver.Launch();
+	Receiver.Cancel();
+	TestTrue(TEXT("Send after cancelled receiver is buffered"), Cancelling.TrySend(1));
+	CoroTasks::TTask<> Sender = Task_ChannelProducer(Cancelling, 1, false);
+	Sender.Launch();
+	Sender.Cancel();
+	TestEqual(TEXT("Buffered value is kept"), Cancelling.TryReceive(), TOptional<int32>(1));
+	TestFalse(TEXT("Cancelled send isn't delivered"), Cancelling.TryReceive().IsSet());
+	return true;
+}
+
+CoroTasks::TTask<> Task_ChannelCounter(CoroTasks::TAsyncChannel<int32>& Channel, int32 Total, FEvent* Done)
+{
+	for (int32 Index = 0; Index < Total; ++Index)
+		co_await Channel.Receive();
+	Done->Trigger();
+}
+
+CoroTasks::TTask<> Task_ChannelWorkerProducer(CoroTasks::TAsyncChannel<int32>& Channel, int32 Count, std::atomic<int32>& ActiveProducers)
+{
+	for (int32 Value = 1; Value <= Count; ++Value)
+		co_await Channel.Send(Value);
+	--ActiveProducers;
+}
+
+bool Test_AsyncChannelThroughput::RunTest(const FString& Parameters)
+{
+	constexpr int32 MessagesPerRun = 1000000;
+
+	for (const int32 NumProducers : {1, 4})
+	{
+		for (const uint32 Capacity : {1u, 16u, 256u, 4096u})
+		{
+			CoroTasks::TAsyncChannel<int32> Channel(Capacity);
+			FEventRef Done;
+			std::atomic<int32> ActiveProducers(NumProducers);
+			const int32 PerProducer = MessagesPerRun / NumProducers;
+
+			const double StartTime = FPlatformTime::Seconds();
+
+			// Everything runs outside of the game thread, so coroutines are resumed inline by the opposite side
+			Async(EAsyncExecution::Thread, [&Channel, &Done, Total = PerProducer * NumProducers]
+			{
+				Task_ChannelCounter(Channel, Total, Done.Get()).Launch();
+			});
+			for (int32 Producer = 0; Producer < NumProducers; ++Producer)
+			{
+				Async(EAsyncExecution::Thread, [&Channel, &ActiveProducers, PerProducer]
+				{
+					Task_ChannelWorkerProducer(Channel, PerProducer, ActiveProducers).Launch();
+				});
+			}
+
+			Done->Wait();
+			while (ActiveProducers.load() > 0)
+				FPlatformProcess::Yield();
+
+			const double Elapsed = FPlatformTime::Seconds() - StartTime;
+			AddInfo(FString::Printf(TEXT("Producers %d, capacity %u: %.0f msg/s"),
+				NumProducers, Channel.GetCapacity(), (PerProducer * NumProducers) / Elapsed));
+		}
+	}
+	return true;
+}
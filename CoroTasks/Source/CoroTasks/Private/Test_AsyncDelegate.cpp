@@ -0,0 +1,144 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Abilities/Tasks/AbilityTask_WaitGameplayEvent.h"
+#include "AsyncDelegate.h"
+#include "CoroTask.h"
+#include "CoroTasksTests.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_AsyncDelegate, "CoroTasks.AsyncDelegate",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FCoroTasksTestDelegate, int32, const FString&);
+
+CoroTasks::TTask<> Task_WaitNative(FCoroTasksTestDelegate& Delegate, int32& OutNumber, FString& OutText)
+{
+	auto [Number, Text] = co_await CoroTasks::WaitDelegate(Delegate);
+	OutNumber = Number;
+	OutText = Text;
+}
+
+CoroTasks::TTask<> Task_WaitDynamic(UAbilityTask_WaitGameplayEvent* Task, float& OutMagnitude)
+{
+	auto [Payload] = co_await CoroTasks::WaitDelegate(Task->EventReceived, Task);
+	OutMagnitude = Payload.EventMagnitude;
+}
+
+CoroTasks::TTask<> Task_WaitSparse(AActor* Trigger, AActor*& OutOtherActor)
+{
+	auto [OverlappedActor, OtherActor] = co_await CoroTasks::WaitDelegate(Trigger->OnActorBeginOverlap, Trigger);
+	OutOtherActor = OtherActor;
+}
+
+struct FReleasedSlotState
+{
+	CoroTasks::TTask<> Waiters[2];
+	CoroTasks::TTask<> Sparse;
+	AActor* Trigger = nullptr;
+	AActor* OtherActor = nullptr;
+	int32 NumResumed = 0;
+};
+
+CoroTasks::TTask<> Task_WaitDynamicThenSparse(UAbilityTask_WaitGameplayEvent* Task, FReleasedSlotState& State, int32 Self)
+{
+	co_await CoroTasks::WaitDelegate(Task->EventReceived, Task);
+	++State.NumResumed;
+	// Slot of the other waiter is released in the middle of the broadcast, the next wait must not get it back
+	State.Waiters[1 - Self].Cancel();
+	State.Sparse = Task_WaitSparse(State.Trigger, State.OtherActor);
+	State.Sparse.Launch();
+}
+
+bool Test_AsyncDelegate::RunTest(const FString& Parameters)
+{
+	{
+		FCoroTasksTestDelegate Delegate;
+		int32 Number = 0;
+		FString Text;
+		auto Task = Task_WaitNative(Delegate, Number, Text);
+		Task.Launch();
+		TestTrue(TEXT("Native delegate is bound while waiting"), Delegate.IsBound());
+
+		Delegate.Broadcast(42, TEXT("Answer"));
+		TestTrue(TEXT("Native wait is resumed"), Task.IsDone());
+		TestEqual(TEXT("Native payload number"), Number, 42);
+		TestEqual(TEXT("Native payload text"), Text, FString(TEXT("Answer")));
+		TestFalse(TEXT("Native delegate is unbound on fire"), Delegate.IsBound());
+	}
+
+	{
+		UAbilityTask_WaitGameplayEvent* AbilityTask = NewObject<UAbilityTask_WaitGameplayEvent>(GetTransientPackage());
+		float Magnitude = 0.f;
+		auto Task = Task_WaitDynamic(AbilityTask, Magnitude);
+		Task.Launch();
+		TestTrue(TEXT("Dynamic delegate is bound while waiting"), AbilityTask->EventReceived.IsBound());
+
+		FGameplayEventData Payload;
+		Payload.EventMagnitude = 3.f;
+		AbilityTask->EventReceived.Broadcast(Payload);
+		TestTrue(TEXT("Dynamic wait is resumed"), Task.IsDone());
+		TestEqual(TEXT("Dynamic payload is read from broadcast parameters"), Magnitude, 3.f);
+		TestFalse(TEXT("Dynamic delegate is unbound on fire"), AbilityTask->EventReceived.IsBound());
+	}
+
+	{
+		FCoroTestWorld World;
+		AActor* Trigger = World.Get()->SpawnActor<AActor>();
+		AActor* Other = World.Get()->SpawnActor<AActor>();
+		AActor* OtherActor = nullptr;
+		auto Task = Task_WaitSparse(Trigger, OtherActor);
+		Task.Launch();
+		TestTrue(TEXT("Sparse delegate is bound while waiting"), Trigger->OnActorBeginOverlap.IsBound());
+
+		Trigger->OnActorBeginOverlap.Broadcast(Trigger, Other);
+		TestTrue(TEXT("Sparse wait is resumed"), Task.IsDone());
+		TestTrue(TEXT("Sparse payload is read from broadcast parameters"), OtherActor == Other);
+		TestFalse(TEXT("Sparse delegate is unbound on fire"), Trigger->OnActorBeginOverlap.IsBound());
+	}
+
+	{
+		FCoroTestWorld World;
+		UAbilityTask_WaitGameplayEvent* AbilityTask = NewObject<UAbilityTask_WaitGameplayEvent>(GetTransientPackage());
+		AActor* Other = World.Get()->SpawnActor<AActor>();
+		FReleasedSlotState State;
+		State.Trigger = World.Get()->SpawnActor<AActor>();
+		for (int32 Index = 0; Index < 2; ++Index)
+		{
+			State.Waiters[Index] = Task_WaitDynamicThenSparse(AbilityTask, State, Index);
+			State.Waiters[Index].Launch();
+		}
+
+		AbilityTask->EventReceived.Broadcast(FGameplayEventData());
+		TestEqual(TEXT("Only one dynamic waiter is resumed"), State.NumResumed, 1);
+		TestFalse(TEXT("Stale call of a released slot doesn't reach its next owner"), State.Sparse.IsDone());
+		TestTrue(TEXT("Wait started during broadcast is bound"), State.Trigger->OnActorBeginOverlap.IsBound());
+
+		State.Trigger->OnActorBeginOverlap.Broadcast(State.Trigger, Other);
+		TestTrue(TEXT("Wait started during broadcast is resumed by its own delegate"), State.Sparse.IsDone());
+		TestTrue(TEXT("Its payload comes from its own delegate"), State.OtherActor == Other);
+	}
+	return true;
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncNavigation.h"
+#include "CoroTask.h"
+#include "CoroTasksTests.h"
+#include "Misc/AutomationTest.h"
+#include "NavMesh/RecastNavMesh.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_AsyncNavigation, "CoroTasks.AsyncNavigation",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+CoroTasks::TTask<> Task_FindPath(UNavigationSystemV1* NavSys, FPathFindingQuery Query, TOptional<FPathFindingResult>& OutResult)
+{
+	OutResult = co_await CoroTasks::FindPathAsync(NavSys, Query);
+}
+
+bool Test_AsyncNavigation::RunTest(const FString& Parameters)
+{
+	using CoroTasks::Private::FAsyncPathDispatcher;
+
+	FCoroTestWorld World;
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World.Get());
+	if (!NavSys)
+	{
+		FNavigationSystem::AddNavigationSystemToWorld(*World.Get(), FNavigationSystemRunMode::GameMode);
+		NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World.Get());
+	}
+	ARecastNavMesh* NavMesh = World.Get()->SpawnActor<ARecastNavMesh>();
+	if (!TestNotNull(TEXT("Navigation system exists"), NavSys) || !TestNotNull(TEXT("Nav mesh is spawned"), NavMesh))
+		return false;
+
+	// Result itself doesn't matter (nothing is built), only who waits for it
+	const FPathFindingQuery Query(nullptr, *NavMesh, FVector::ZeroVector, FVector(1000.0, 0.0, 0.0));
+	const int32 NumPendingBefore = FAsyncPathDispatcher::GetNumPendingQueries();
+
+	{
+		TOptional<FPathFindingResult> First;
+		TOptional<FPathFindingResult> Second;
+		auto FirstTask = Task_FindPath(NavSys, Query, First);
+		auto SecondTask = Task_FindPath(NavSys, Query, Second);
+		FirstTask.Launch();
+		SecondTask.Launch();
+		TestEqual(TEXT("Identical queries of a frame are coalesced"), FAsyncPathDispatcher::GetNumPendingQueries(), NumPendingBefore + 1);
+
+		TestTrue(TEXT("Both waits are resumed"), World.TickUntil([&] { return First.IsSet() && Second.IsSet(); }));
+		if (First.IsSet() && Second.IsSet())
+		{
+			TestEqual(TEXT("Coalesced waits get the same result"), (int32)First->Result, (int32)Second->Result);
+			TestTrue(TEXT("Each wait gets its own path"), !First->Path.IsValid() || First->Path != Second->Path);
+		}
+		TestEqual(TEXT("Finished query is forgotten"), FAsyncPathDispatcher::GetNumPendingQueries(), NumPendingBefore);
+	}
+
+	{
+		World.Tick();
+		TOptional<FPathFindingResult> First;
+		TOptional<FPathFindingResult> Second;
+		auto FirstTask = Task_FindPath(NavSys, Query, First);
+		auto SecondTask = Task_FindPath(NavSys, Query, Second);
+		FirstTask.Launch();
+		SecondTask.Launch();
+
+		FirstTask.Cancel();
+		TestEqual(TEXT("Query runs while somebody waits for it"), FAsyncPathDispatcher::GetNumPendingQueries(), NumPendingBefore + 1);
+		SecondTask.Cancel();
+		TestEqual(TEXT("Query is aborted when the last awaiter leaves"), FAsyncPathDispatcher::GetNumPendingQueries(), NumPendingBefore);
+
+		World.Tick();
+		World.Tick();
+		TestFalse(TEXT("Cancelled waits are never resumed"), First.IsSet() || Second.IsSet());
+	}
+	return true;
+}
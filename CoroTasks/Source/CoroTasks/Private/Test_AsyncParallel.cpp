@@ -0,0 +1,88 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncParallel.h"
+#include "CoroTasksTests.h"
+#include "TaskInterop.h"
+
+IMPLEMENT_ASYNC_AUTOMATION_TEST(Test_AsyncParallel, "CoroTasks.AsyncParallel", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter);
+
+CoroTasks::TTask<> Task_SlowParallelFor(int32 Num, std::atomic<int32>& NumProcessed, bool& bResumed)
+{
+	co_await CoroTasks::ParallelFor(Num, [&NumProcessed] (int32)
+	{
+		FPlatformProcess::Sleep(0.001f);
+		++NumProcessed;
+	});
+	bResumed = true;
+}
+
+CoroTasks::TTask<void> Test_AsyncParallel::RunTest_Async(const FString Parameters)
+{
+	constexpr int32 Num = 10000;
+	TArray<int64> Squares;
+	Squares.SetNumZeroed(Num);
+	co_await CoroTasks::ParallelFor(Num, [&Squares] (int32 Index) { Squares[Index] = (int64)Index * Index; }, 64);
+
+	if (!IsInGameThread())
+		ASYNC_TEST_FAIL(TEXT("Coroutine should continue on the game thread"));
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		if (Squares[Index] != (int64)Index * Index)
+			ASYNC_TEST_FAIL(FString::Printf(TEXT("Item %d is not processed"), Index));
+	}
+
+	// Cost of items grows with index, stealing should still process each item exactly once
+	const int64 Sum = co_await CoroTasks::ParallelReduce(Num, (int64)0,
+		[] (int32 Index)
+		{
+			double Work = 0.0;
+			for (int32 Step = 0; Step < Index / 10; ++Step)
+				Work += FMath::Sqrt((double)Step);
+			return (int64)Index + (Work < 0.0 ? 1 : 0);
+		},
+		[] (int64 A, int64 B) { return A + B; });
+	if (Sum != (int64)Num * (Num - 1) / 2)
+		ASYNC_TEST_FAIL(TEXT("ParallelReduce result is wrong"));
+
+	bool bEmptyIsReady = true;
+	co_await CoroTasks::ParallelFor(0, [&bEmptyIsReady] (int32) { bEmptyIsReady = false; });
+	if (!bEmptyIsReady)
+		ASYNC_TEST_FAIL(TEXT("Empty range shouldn't call body"));
+
+	// Cancel returns when no worker uses the frame anymore
+	constexpr int32 NumSlow = 1000;
+	std::atomic<int32> NumProcessed = 0;
+	bool bResumed = false;
+	CoroTasks::TTask<> Cancelled = Task_SlowParallelFor(NumSlow, NumProcessed, bResumed);
+	Cancelled.Launch();
+	Cancelled.Cancel();
+	const int32 NumProcessedAtCancel = NumProcessed.load();
+	co_await UE::Tasks::Launch(UE_SOURCE_LOCATION, [] { FPlatformProcess::Sleep(0.05f); });
+	if (NumProcessed.load() != NumProcessedAtCancel)
+		ASYNC_TEST_FAIL(TEXT("Workers kept running after cancel"));
+	if (NumProcessedAtCancel == NumSlow)
+		ASYNC_TEST_FAIL(TEXT("Cancel should skip remaining items"));
+	if (bResumed)
+		ASYNC_TEST_FAIL(TEXT("Cancelled ParallelFor resumed its coroutine"));
+}
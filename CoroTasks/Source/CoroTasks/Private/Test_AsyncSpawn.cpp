@@ -0,0 +1,81 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncSpawn.h"
+#include "CoroTask.h"
+#include "CoroTasksTests.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_AsyncSpawn, "CoroTasks.AsyncSpawn",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+CoroTasks::TTask<> Task_SpawnWithPriority(UWorld* World, float Priority, TArray<float>& Order)
+{
+	AActor* Actor = co_await CoroTasks::SpawnActorAsync<AActor>(World, AActor::StaticClass(), FTransform::Identity, {}, Priority);
+	if (Actor)
+		Order.Add(Priority);
+}
+
+bool Test_AsyncSpawn::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* BudgetMs = IConsoleManager::Get().FindConsoleVariable(TEXT("CoroTasks.SpawnBudgetMs"));
+	if (!TestNotNull(TEXT("Budget variable exists"), BudgetMs))
+		return false;
+
+	// No budget: a single spawn per frame
+	const float OriginalBudgetMs = BudgetMs->GetFloat();
+	BudgetMs->Set(0.f, ECVF_SetByCode);
+
+	FCoroTestWorld World;
+	UCoroSpawnSubsystem* Subsystem = World.Get()->GetSubsystem<UCoroSpawnSubsystem>();
+	TArray<float> Order;
+	TArray<CoroTasks::TTask<>> Tasks;
+	for (const float Priority : {1.f, 3.f, 2.f})
+	{
+		Tasks.Add(Task_SpawnWithPriority(World.Get(), Priority, Order));
+		Tasks.Last().Launch();
+	}
+	TestEqual(TEXT("Requests are queued"), Subsystem->GetNumQueued(), 3);
+
+	World.Tick();
+	TestEqual(TEXT("Spent budget still spawns one actor per frame"), Order.Num(), 1);
+	TestEqual(TEXT("Rest waits for the next frames"), Subsystem->GetNumQueued(), 2);
+
+	TestTrue(TEXT("Every request is spawned"), World.TickUntil([&Order] { return Order.Num() == 3; }, 4));
+	TestEqual(TEXT("Higher priority spawns first"), Order, TArray<float>{3.f, 2.f, 1.f});
+
+	BudgetMs->Set(1000.f, ECVF_SetByCode);
+	Order.Reset();
+	for (int32 Index = 0; Index < 3; ++Index)
+	{
+		Tasks.Add(Task_SpawnWithPriority(World.Get(), 0.f, Order));
+		Tasks.Last().Launch();
+	}
+	World.Tick();
+	TestEqual(TEXT("Budget fits the whole queue in one frame"), Order.Num(), 3);
+
+	BudgetMs->Set(OriginalBudgetMs, ECVF_SetByCode);
+	return true;
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncSync.h"
+#include "CoroTask.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_AsyncSync, "CoroTasks.AsyncSync",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+CoroTasks::TTask<> Task_SemaphoreUser(CoroTasks::FAsyncSemaphore& Semaphore, CoroTasks::FAsyncEvent& Event, TArray<int32>& Order, int32 Id)
+{
+	auto Permit = co_await Semaphore.AcquireScoped();
+	Order.Add(Id);
+	co_await Event.Wait();
+}
+
+CoroTasks::TTask<> Task_MutexUser(CoroTasks::FAsyncMutex& Mutex, CoroTasks::FAsyncEvent& Event, TArray<int32>& Order, int32 Id)
+{
+	auto Lock = co_await Mutex.Lock();
+	Order.Add(Id);
+	co_await Event.Wait();
+	Order.Add(-Id);
+}
+
+CoroTasks::TTask<> Task_SemaphoreWaiter(CoroTasks::FAsyncSemaphore& Semaphore, int32& Resumed)
+{
+	co_await Semaphore.Acquire();
+	++Resumed;
+}
+
+CoroTasks::TTask<> Task_SemaphoreCancelSibling(CoroTasks::FAsyncSemaphore& Semaphore, CoroTasks::TTask<>& Sibling, int32& Resumed)
+{
+	co_await Semaphore.Acquire();
+	++Resumed;
+	Sibling.Cancel();
+}
+
+CoroTasks::TTask<> Task_EventWaiter(CoroTasks::FAsyncEvent& Event, int32& Resumed)
+{
+	co_await Event.Wait();
+	++Resumed;
+}
+
+bool Test_AsyncSync::RunTest(const FString& Parameters)
+{
+	{
+		CoroTasks::FAsyncSemaphore Semaphore(2);
+		CoroTasks::FAsyncEvent Event(EEventMode::ManualReset);
+		TArray<int32> Order;
+		for (int32 Id = 1; Id <= 4; ++Id)
+			Task_SemaphoreUser(Semaphore, Event, Order, Id).Launch();
+
+		TestEqual(TEXT("Only two users hold the semaphore"), Order, TArray<int32>{1, 2});
+		Event.Trigger();
+		TestEqual(TEXT("Waiters are resumed in FIFO order"), Order, TArray<int32>{1, 2, 3, 4});
+		TestEqual(TEXT("All permits are returned"), Semaphore.GetAvailableCount(), 2);
+	}
+
+	{
+		CoroTasks::FAsyncMutex Mutex;
+		CoroTasks::FAsyncEvent Event(EEventMode::AutoReset);
+		TArray<int32> Order;
+		Task_MutexUser(Mutex, Event, Order, 1).Launch();
+		Task_MutexUser(Mutex, Event, Order, 2).Launch();
+
+		TestEqual(TEXT("Second user waits for the lock"), Order, TArray<int32>{1});
+		Event.Trigger();
+		TestEqual(TEXT("Auto reset event resumes one waiter"), Order, TArray<int32>{1, -1, 2});
+		Event.Trigger();
+		TestEqual(TEXT("Lock is released by scope"), Order, TArray<int32>{1, -1, 2, -2});
+		TestFalse(TEXT("Mutex is unlocked"), Mutex.IsLocked());
+	}
+
+	{
+		CoroTasks::FAsyncSemaphore Semaphore(0);
+		int32 Resumed = 0;
+		CoroTasks::TTask<> Cancelled = Task_SemaphoreWaiter(Semaphore, Resumed);
+		Cancelled.Launch();
+		Cancelled.Cancel();
+		Semaphore.Release();
+		TestEqual(TEXT("Cancelled waiter doesn't take the permit"), Semaphore.GetAvailableCount(), 1);
+		TestEqual(TEXT("Cancelled waiter isn't resumed"), Resumed, 0);
+	}
+
+	{
+		// Second waiter is cancelled after Release handed it a permit, the permit goes to the third one
+		CoroTasks::FAsyncSemaphore Semaphore(0);
+		int32 Resumed = 0;
+		CoroTasks::TTask<> Second;
+		CoroTasks::TTask<> First = Task_SemaphoreCancelSibling(Semaphore, Second, Resumed);
+		Second = Task_SemaphoreWaiter(Semaphore, Resumed);
+		CoroTasks::TTask<> Third = Task_SemaphoreWaiter(Semaphore, Resumed);
+		First.Launch();
+		Second.Launch();
+		Third.Launch();
+
+		Semaphore.Release(2);
+		TestEqual(TEXT("Handed permit isn't lost"), Resumed, 2);
+		TestTrue(TEXT("Third waiter got the permit"), Third.IsDone());
+		TestEqual(TEXT("No permit is left"), Semaphore.GetAvailableCount(), 0);
+	}
+
+	{
+		CoroTasks::FAsyncEvent Event(EEventMode::AutoReset);
+		int32 Resumed = 0;
+		CoroTasks::TTask<> Cancelled = Task_EventWaiter(Event, Resumed);
+		Cancelled.Launch();
+		Cancelled.Cancel();
+		Event.Trigger();
+		TestEqual(TEXT("Cancelled event waiter isn't resumed"), Resumed, 0);
+		TestTrue(TEXT("Trigger stays for the next waiter"), Event.IsTriggered());
+	}
+	return true;
+}
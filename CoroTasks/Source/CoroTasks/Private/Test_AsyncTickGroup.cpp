@@ -0,0 +1,63 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncTickGroup.h"
+#include "CoroTask.h"
+#include "CoroTasksTests.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_AsyncTickGroup, "CoroTasks.AsyncTickGroup",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+CoroTasks::TTask<> Task_WalkGroups(UWorld* World, TArray<uint64>& Frames)
+{
+	co_await CoroTasks::NextTick(World, TG_PrePhysics);
+	Frames.Add(GFrameCounter);
+	co_await CoroTasks::NextTick(World, TG_PostPhysics);
+	Frames.Add(GFrameCounter);
+	co_await CoroTasks::NextTick(World, TG_PrePhysics);
+	Frames.Add(GFrameCounter);
+}
+
+bool Test_AsyncTickGroup::RunTest(const FString& Parameters)
+{
+	FCoroTestWorld World;
+	// First wait in a group issued during the world tick resumes a frame later, so the group is registered up front
+	World.Get()->GetSubsystem<UCoroTickGroupSubsystem>()->GetTickFunction(TG_PostPhysics);
+
+	TArray<uint64> Frames;
+	auto Task = Task_WalkGroups(World.Get(), Frames);
+	Task.Launch();
+	TestTrue(TEXT("Nothing is resumed outside of the world tick"), Frames.IsEmpty());
+
+	World.Tick();
+	const uint64 FirstFrame = GFrameCounter;
+	TestEqual(TEXT("Wait issued between frames resumes in the next one"), Frames.Num(), 2);
+	TestTrue(TEXT("Later group of the same frame resumes in that frame"), Frames.Num() == 2 && Frames[0] == FirstFrame && Frames[1] == FirstFrame);
+
+	World.Tick();
+	TestTrue(TEXT("Group that already ticked resumes in the next frame"), Frames.Num() == 3 && Frames[2] == FirstFrame + 1);
+	TestTrue(TEXT("Task is done"), Task.IsDone());
+	return true;
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncTrace.h"
+#include "CoroTask.h"
+#include "CoroTasksTests.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_AsyncTrace, "CoroTasks.AsyncTrace",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+CoroTasks::TTask<> Task_LineTrace(UWorld* World, bool& bResumed)
+{
+	co_await CoroTasks::AsyncLineTrace(World, EAsyncTraceType::Multi, FVector::ZeroVector, FVector(1000.0, 0.0, 0.0), ECC_Visibility);
+	bResumed = true;
+}
+
+bool Test_AsyncTrace::RunTest(const FString& Parameters)
+{
+	FCoroTestWorld World;
+
+	{
+		bool bResumed = false;
+		auto Task = Task_LineTrace(World.Get(), bResumed);
+		Task.Launch();
+		TestFalse(TEXT("Trace result comes with a world tick"), bResumed);
+		TestTrue(TEXT("Trace is resumed"), World.TickUntil([&bResumed] { return bResumed; }, 4));
+	}
+
+	{
+		bool bResumed = false;
+		auto Task = Task_LineTrace(World.Get(), bResumed);
+		Task.Launch();
+		Task.Cancel();
+		World.Tick();
+		World.Tick();
+		World.Tick();
+		TestFalse(TEXT("Trace cancelled before its result isn't resumed"), bResumed);
+
+		bool bNextResumed = false;
+		auto NextTask = Task_LineTrace(World.Get(), bNextResumed);
+		NextTask.Launch();
+		TestTrue(TEXT("Next trace is resumed after a cancelled one"), World.TickUntil([&bNextResumed] { return bNextResumed; }, 4));
+	}
+	return true;
+}
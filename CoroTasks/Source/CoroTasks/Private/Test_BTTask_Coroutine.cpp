@@ -0,0 +1,105 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AIController.h"
+#include "BTTask_CoroutineTest.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/Composites/BTComposite_Sequence.h"
+#include "CoroTasksTests.h"
+#include "Engine/World.h"
+#include "Misc/ScopeExit.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_BTTask_Coroutine, "CoroTasks.BTTask_Coroutine",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+CoroTasks::TTask<EBTNodeResult::Type> UBTTask_CoroutineTest::ExecuteCoroutine(UBehaviorTreeComponent& OwnerComp)
+{
+	++NumStarted;
+	ON_SCOPE_EXIT { ++NumDestroyed; };
+	if (Gate)
+		co_await Gate->Wait();
+	++NumFinished;
+	co_return Result;
+}
+
+namespace
+{
+	/** Single run tree with the node under a sequence */
+	UBehaviorTree* MakeTree(UBTTask_CoroutineTest*& OutNode)
+	{
+		UBehaviorTree* Tree = NewObject<UBehaviorTree>(GetTransientPackage());
+		UBTComposite_Sequence* Root = NewObject<UBTComposite_Sequence>(Tree);
+		OutNode = NewObject<UBTTask_CoroutineTest>(Tree);
+		Root->Children.AddDefaulted_GetRef().ChildTask = OutNode;
+		Tree->RootNode = Root;
+		return Tree;
+	}
+}
+
+bool Test_BTTask_Coroutine::RunTest(const FString& Parameters)
+{
+	FCoroTestWorld World;
+	AAIController* Controller = World.Get()->SpawnActor<AAIController>();
+	if (!TestNotNull(TEXT("Controller is spawned"), Controller))
+		return false;
+
+	UBehaviorTreeComponent* BehaviorTree = NewObject<UBehaviorTreeComponent>(Controller);
+	BehaviorTree->RegisterComponent();
+
+	// Coroutine that doesn't suspend returns its result from ExecuteTask
+	UBTTask_CoroutineTest* SyncNode = nullptr;
+	BehaviorTree->StartTree(*MakeTree(SyncNode), EBTExecutionMode::SingleRun);
+	World.TickUntil([SyncNode] { return SyncNode->NumFinished > 0; }, 4);
+	TestEqual(TEXT("Sync node is executed once"), SyncNode->NumStarted, 1);
+	TestEqual(TEXT("Sync node finishes"), SyncNode->NumFinished, 1);
+	TestTrue(TEXT("Sync node isn't active after ExecuteTask"), BehaviorTree->GetTaskStatus(SyncNode) == EBTTaskStatus::Inactive);
+	BehaviorTree->StopTree();
+
+	// Suspended coroutine finishes the latent task when it's resumed
+	CoroTasks::FAsyncEvent Gate(EEventMode::ManualReset);
+	UBTTask_CoroutineTest* LatentNode = nullptr;
+	UBehaviorTree* LatentTree = MakeTree(LatentNode);
+	LatentNode->Gate = &Gate;
+	BehaviorTree->StartTree(*LatentTree, EBTExecutionMode::SingleRun);
+	World.TickUntil([LatentNode] { return LatentNode->NumStarted > 0; }, 4);
+	TestTrue(TEXT("Latent node waits"), BehaviorTree->GetTaskStatus(LatentNode) == EBTTaskStatus::Active);
+
+	Gate.Trigger();
+	TestEqual(TEXT("Latent node finishes"), LatentNode->NumFinished, 1);
+	World.Tick();
+	TestTrue(TEXT("FinishLatentTask deactivates the node"), BehaviorTree->GetTaskStatus(LatentNode) == EBTTaskStatus::Inactive);
+	BehaviorTree->StopTree();
+
+	// Abort destroys the suspended frame, a later trigger resumes nothing
+	Gate.Reset();
+	BehaviorTree->StartTree(*LatentTree, EBTExecutionMode::SingleRun);
+	World.TickUntil([LatentNode] { return LatentNode->NumStarted > 1; }, 4);
+	TestTrue(TEXT("Latent node waits again"), BehaviorTree->GetTaskStatus(LatentNode) == EBTTaskStatus::Active);
+
+	BehaviorTree->StopTree();
+	TestEqual(TEXT("Abort destroys the frame"), LatentNode->NumDestroyed, 2);
+	Gate.Trigger();
+	TestEqual(TEXT("Aborted coroutine isn't resumed"), LatentNode->NumFinished, 1);
+	return true;
+}
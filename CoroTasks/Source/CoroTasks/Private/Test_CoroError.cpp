@@ -0,0 +1,70 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroTask.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_CoroError, "CoroTasks.CoroError",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+CoroTasks::TTask<int32> Task_MayFail(bool bFail)
+{
+	if (bFail)
+		CORO_FAIL(FCoroError(TEXT("Requested failure")));
+	co_return 10;
+}
+
+CoroTasks::TTask<int32> Task_Forward(bool bFail)
+{
+	CORO_TRY(Value, Task_MayFail(bFail));
+	co_return Value + 1;
+}
+
+CoroTasks::TTask<> Task_CatchError(bool bFail, FString& OutResult)
+{
+#if COROTASKS_WITH_EXCEPTIONS
+	try
+	{
+		const int32 Value = co_await Task_Forward(bFail);
+		OutResult = FString::FromInt(Value);
+	} catch (const FCoroError& Error)
+	{
+		OutResult = Error.GetMessage();
+	}
+#else
+	auto Result = co_await Task_Forward(bFail);
+	OutResult = Result.HasError() ? Result.GetError().GetMessage() : FString::FromInt(Result.GetValue());
+#endif
+}
+
+bool Test_CoroError::RunTest(const FString& Parameters)
+{
+	FString Success;
+	Task_CatchError(false, Success).Launch();
+	TestEqual(TEXT("Value is forwarded by CORO_TRY"), Success, FString(TEXT("11")));
+
+	FString Failure;
+	Task_CatchError(true, Failure).Launch();
+	TestEqual(TEXT("Error is forwarded by CORO_TRY"), Failure, FString(TEXT("Requested failure")));
+	return true;
+}
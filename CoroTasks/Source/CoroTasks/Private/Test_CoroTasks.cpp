@@ -33,11 +33,11 @@ CoroTasks::TTask<void> Test_CoroTasks::RunTest_Async(const FString Parameters)
 	const TSoftObjectPtr<UObject> SoftObjectToLoad = GetDefault<UCoroTasksTestsSettings>()->TestObjectToLoad;
 
 	if (SoftObjectToLoad.IsNull())
-		throw FAsyncTestException(TEXT("Can't find asset"));
+		ASYNC_TEST_FAIL(TEXT("Can't find asset"));
 
 	const UObject* Object = co_await CoroTasks::LoadSingleObject(SoftObjectToLoad);
 
 	if (Object == nullptr)
-		throw FAsyncTestException(TEXT("Something went wrong"));
+		ASYNC_TEST_FAIL(TEXT("Something went wrong"));
 	
 }
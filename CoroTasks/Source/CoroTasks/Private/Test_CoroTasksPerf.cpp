@@ -0,0 +1,247 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroCountingMalloc.h"
+#include "CoroTask.h"
+#include "CoroTasksSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_CoroTasksPerf, "CoroTasks.Perf.Core",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+namespace
+{
+	struct FPerfResult
+	{
+		FString Name;
+		int32 Iterations;
+		double NsPerOp;
+		double AllocationsPerOp;
+	};
+
+	/** Swaps GMalloc for the lifetime of the suite. Proxy is never freed: other threads may still be inside of it */
+	struct FPerfSuite
+	{
+		FPerfSuite()
+			: OriginalMalloc(GMalloc)
+		{
+			static CoroTasks::FCountingMalloc* CountingMalloc = new CoroTasks::FCountingMalloc(GMalloc);
+			Counting = CountingMalloc;
+			GMalloc = Counting;
+		}
+
+		~FPerfSuite()
+		{
+			GMalloc = OriginalMalloc;
+		}
+
+		template<typename Callable>
+		void Measure(const FString& Name, int32 Iterations, Callable&& Body)
+		{
+			// Warm up caches and pooled frames
+			for (int32 Index = 0; Index < FMath::Min(Iterations, 1000); ++Index)
+				Body();
+
+			Counting->Begin();
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			for (int32 Index = 0; Index < Iterations; ++Index)
+				Body();
+			const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+			const uint64 NumAllocations = Counting->End();
+
+			Results.Add({Name, Iterations, FPlatformTime::ToMilliseconds64(Cycles) * 1000000.0 / Iterations, (double)NumAllocations / Iterations});
+		}
+
+		FString ToJson() const
+		{
+			TArray<TSharedPtr<FJsonValue>> Benchmarks;
+			for (const FPerfResult& Result : Results)
+			{
+				TSharedRef<FJsonObject> Benchmark = MakeShared<FJsonObject>();
+				Benchmark->SetStringField(TEXT("Name"), Result.Name);
+				Benchmark->SetNumberField(TEXT("Iterations"), Result.Iterations);
+				Benchmark->SetNumberField(TEXT("NsPerOp"), Result.NsPerOp);
+				Benchmark->SetNumberField(TEXT("AllocationsPerOp"), Result.AllocationsPerOp);
+				Benchmarks.Add(MakeShared<FJsonValueObject>(Benchmark));
+			}
+			TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+			Root->SetArrayField(TEXT("Benchmarks"), Benchmarks);
+
+			FString Json;
+			FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Json));
+			return Json;
+		}
+
+		FMalloc* OriginalMalloc;
+		CoroTasks::FCountingMalloc* Counting;
+		TArray<FPerfResult> Results;
+	};
+
+	int32 Sink = 0;
+
+	CoroTasks::TTask<> Perf_Empty()
+	{
+		++Sink;
+		co_return;
+	}
+
+	CoroTasks::TTask<int32> Perf_Chain(int32 Depth)
+	{
+		if (Depth == 0)
+			co_return 1;
+		co_return 1 + co_await Perf_Chain(Depth - 1);
+	}
+
+	CoroTasks::TTask<> Perf_ChainRoot(int32 Depth)
+	{
+		Sink += co_await Perf_Chain(Depth);
+	}
+
+	void Perf_CallbackChain(int32 Depth, TFunction<void(int32)>&& Done)
+	{
+		if (Depth == 0)
+		{
+			Done(1);
+			return;
+		}
+		Perf_CallbackChain(Depth - 1, [Done = MoveTemp(Done)] (int32 Value)
+		{
+			Done(Value + 1);
+		});
+	}
+
+	CoroTasks::TFuture<int32> Perf_ReadyFuture()
+	{
+		CoroTasks::TFuture<int32> Future;
+		Future.SetResult(1);
+		return Future;
+	}
+
+	CoroTasks::TTask<> Perf_AwaitReady()
+	{
+		Sink += co_await Perf_ReadyFuture();
+	}
+
+	CoroTasks::TTask<> Perf_AwaitFuture(TSharedRef<CoroTasks::TFuture<int32>> Future)
+	{
+		Sink += co_await Future;
+	}
+}
+
+bool Test_CoroTasksPerf::RunTest(const FString& Parameters)
+{
+	FPerfSuite Suite;
+
+	Suite.Measure(TEXT("Task.CreateLaunchComplete"), 1000000, []
+	{
+		Perf_Empty().Launch();
+	});
+	Suite.Measure(TEXT("Baseline.TFunction.CreateCall"), 1000000, []
+	{
+		TFunction<void()> Function = [] { ++Sink; };
+		Function();
+	});
+
+	for (const int32 Depth : {1, 10, 100})
+	{
+		const int32 Iterations = 1000000 / Depth;
+		Suite.Measure(FString::Printf(TEXT("Task.AwaitChain/%d"), Depth), Iterations, [Depth]
+		{
+			Perf_ChainRoot(Depth).Launch();
+		});
+		Suite.Measure(FString::Printf(TEXT("Baseline.TFunction.CallbackChain/%d"), Depth), Iterations, [Depth]
+		{
+			Perf_CallbackChain(Depth, [] (int32 Value) { Sink += Value; });
+		});
+	}
+
+	Suite.Measure(TEXT("Future.AwaitReady"), 1000000, []
+	{
+		Perf_AwaitReady().Launch();
+	});
+	Suite.Measure(TEXT("Baseline.Delegate.BindExecute"), 1000000, []
+	{
+		TDelegate<void(int32)> Delegate = TDelegate<void(int32)>::CreateLambda([] (int32 Value) { Sink += Value; });
+		Delegate.ExecuteIfBound(1);
+	});
+
+	Suite.Measure(TEXT("Future.SetResultResume"), 1000000, []
+	{
+		auto Future = MakeShared<CoroTasks::TFuture<int32>>();
+		Perf_AwaitFuture(Future).Launch();
+		Future->SetResult(1);
+	});
+	Suite.Measure(TEXT("Baseline.TFunction.SharedCallback"), 1000000, []
+	{
+		auto Callback = MakeShared<TFunction<void(int32)>>([] (int32 Value) { Sink += Value; });
+		(*Callback)(1);
+	});
+
+	UCoroTasksSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UCoroTasksSubsystem>() : nullptr;
+	for (const int32 NumPending : {0, 16, 256, 4096})
+	{
+		if (Subsystem)
+		{
+			bool bFinish = false;
+			const int32 NumPendingBefore = Subsystem->GetNumPendingActions();
+			for (int32 Index = 0; Index < NumPending; ++Index)
+				Subsystem->CreateLatentPollingAction<void>([&bFinish] { return bFinish; });
+			TestEqual(TEXT("Polling actions are pending"), Subsystem->GetNumPendingActions(), NumPendingBefore + NumPending);
+
+			Suite.Measure(FString::Printf(TEXT("Subsystem.Tick/%d"), NumPending), 1000, [Subsystem]
+			{
+				Subsystem->Tick(0.f);
+			});
+
+			bFinish = true;
+			Subsystem->Tick(0.f);
+			TestEqual(TEXT("Finished polling actions are removed"), Subsystem->GetNumPendingActions(), NumPendingBefore);
+		}
+
+		FTSTicker Ticker;
+		for (int32 Index = 0; Index < NumPending; ++Index)
+			Ticker.AddTicker(FTickerDelegate::CreateLambda([] (float) { ++Sink; return true; }));
+		Suite.Measure(FString::Printf(TEXT("Baseline.Ticker.Tick/%d"), NumPending), 1000, [&Ticker]
+		{
+			Ticker.Tick(0.f);
+		});
+	}
+
+	for (const FPerfResult& Result : Suite.Results)
+	{
+		AddInfo(FString::Printf(TEXT("%-40s %10.1f ns/op %8.2f allocs/op"), *Result.Name, Result.NsPerOp, Result.AllocationsPerOp));
+	}
+
+	FString JsonPath = FPaths::ProjectSavedDir() / TEXT("Automation") / TEXT("CoroTasksPerf.json");
+	FParse::Value(FCommandLine::Get(), TEXT("CoroTasksPerfJson="), JsonPath);
+	if (!FFileHelper::SaveStringToFile(Suite.ToJson(), *JsonPath))
+		AddError(FString::Printf(TEXT("Can't write %s"), *JsonPath));
+	else
+		AddInfo(FString::Printf(TEXT("Results are written to %s"), *JsonPath));
+	return true;
+}
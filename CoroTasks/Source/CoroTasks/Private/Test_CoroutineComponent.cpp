@@ -0,0 +1,130 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncSync.h"
+#include "CoroTasksSubsystem.h"
+#include "CoroTasksTests.h"
+#include "CoroutineComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/ScopeExit.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_CoroutineComponent, "CoroTasks.CoroutineComponent",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+CoroTasks::TTask<> Task_CountTicks(UCoroutineComponent* Coroutines, int32& NumTicks)
+{
+	co_await Coroutines->NextTick();
+	++NumTicks;
+	co_await Coroutines->NextTick();
+	++NumTicks;
+}
+
+CoroTasks::TTask<> Task_WaitDelay(bool& bResumed, bool& bDestroyed)
+{
+	ON_SCOPE_EXIT { bDestroyed = true; };
+	co_await CoroTasks::Delay(1.0);
+	bResumed = true;
+}
+
+CoroTasks::TTask<> Task_WaitEvent(CoroTasks::FAsyncEvent& Event, bool& bResumed, bool& bDestroyed)
+{
+	ON_SCOPE_EXIT { bDestroyed = true; };
+	co_await Event.Wait();
+	bResumed = true;
+}
+
+CoroTasks::TTask<> Task_WaitPermit(CoroTasks::FAsyncSemaphore& Semaphore, bool& bResumed, bool& bDestroyed)
+{
+	ON_SCOPE_EXIT { bDestroyed = true; };
+	co_await Semaphore.Acquire();
+	bResumed = true;
+}
+
+bool Test_CoroutineComponent::RunTest(const FString& Parameters)
+{
+	UCoroTasksSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UCoroTasksSubsystem>() : nullptr;
+	if (!TestNotNull(TEXT("Subsystem exists"), Subsystem))
+		return false;
+
+	FCoroTestWorld World;
+	AActor* Actor = World.Get()->SpawnActor<AActor>();
+	if (!TestNotNull(TEXT("Actor is spawned"), Actor))
+		return false;
+
+	UCoroutineComponent* Coroutines = NewObject<UCoroutineComponent>(Actor);
+	Coroutines->RegisterComponent();
+	TestFalse(TEXT("Idle component doesn't tick"), Coroutines->IsComponentTickEnabled());
+
+	int32 NumTicks = 0;
+	Coroutines->Run(Task_CountTicks(Coroutines, NumTicks));
+	TestTrue(TEXT("Waiting for the next tick enables tick"), Coroutines->IsComponentTickEnabled());
+	TestTrue(TEXT("Every wait is resumed"), World.TickUntil([&NumTicks] { return NumTicks == 2; }, 4));
+	TestFalse(TEXT("Tick is disabled when nothing waits"), Coroutines->IsComponentTickEnabled());
+	TestEqual(TEXT("Finished coroutine isn't running"), Coroutines->GetNumRunning(), 0);
+
+	// A frame parked on a delay must not be resumed after EndPlay destroyed it
+	Subsystem->SetVirtualClock(true);
+	bool bResumed = false;
+	bool bDestroyed = false;
+	Coroutines->Run(Task_WaitDelay(bResumed, bDestroyed));
+	TestEqual(TEXT("Delayed coroutine is running"), Coroutines->GetNumRunning(), 1);
+
+	Actor->Destroy();
+	TestTrue(TEXT("EndPlay destroys the frame"), bDestroyed);
+	TestEqual(TEXT("Nothing runs after EndPlay"), Coroutines->GetNumRunning(), 0);
+
+	Subsystem->AdvanceVirtualClock(2.0);
+	TestFalse(TEXT("Cancelled coroutine isn't resumed by its delay"), bResumed);
+	Subsystem->SetVirtualClock(false);
+
+	// Waiters parked on sync primitives are unlinked when EndPlay destroys their frames
+	AActor* Waiter = World.Get()->SpawnActor<AActor>();
+	if (!TestNotNull(TEXT("Waiter is spawned"), Waiter))
+		return false;
+
+	UCoroutineComponent* WaiterCoroutines = NewObject<UCoroutineComponent>(Waiter);
+	WaiterCoroutines->RegisterComponent();
+
+	CoroTasks::FAsyncEvent Event;
+	CoroTasks::FAsyncSemaphore Semaphore(0);
+	bool bEventResumed = false;
+	bool bEventDestroyed = false;
+	bool bPermitResumed = false;
+	bool bPermitDestroyed = false;
+	WaiterCoroutines->Run(Task_WaitEvent(Event, bEventResumed, bEventDestroyed));
+	WaiterCoroutines->Run(Task_WaitPermit(Semaphore, bPermitResumed, bPermitDestroyed));
+	TestEqual(TEXT("Both waiters are running"), WaiterCoroutines->GetNumRunning(), 2);
+
+	Waiter->Destroy();
+	TestTrue(TEXT("EndPlay destroys the event waiter"), bEventDestroyed);
+	TestTrue(TEXT("EndPlay destroys the semaphore waiter"), bPermitDestroyed);
+
+	Event.Trigger();
+	Semaphore.Release();
+	TestFalse(TEXT("Cancelled coroutine isn't resumed by its event"), bEventResumed);
+	TestFalse(TEXT("Cancelled coroutine isn't resumed by its semaphore"), bPermitResumed);
+	TestEqual(TEXT("Permit isn't handed to a cancelled waiter"), Semaphore.GetAvailableCount(), 1);
+	return true;
+}
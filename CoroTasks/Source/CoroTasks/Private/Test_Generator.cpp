@@ -0,0 +1,62 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroGenerator.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_Generator, "CoroTasks.Generator",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+struct FGeneratorTestNode
+{
+	int32 Value;
+	TArray<FGeneratorTestNode> Children;
+};
+
+CoroTasks::TGenerator<int32&> Generator_Elements(TArray<int32>& Array)
+{
+	for (int32& Element : Array)
+		co_yield Element;
+}
+
+CoroTasks::TGenerator<const FGeneratorTestNode&> Generator_Walk(const FGeneratorTestNode& Node)
+{
+	co_yield Node;
+	for (const FGeneratorTestNode& Child : Node.Children)
+		co_yield Generator_Walk(Child);
+}
+
+bool Test_Generator::RunTest(const FString& Parameters)
+{
+	TArray<int32> Array = {1, 2, 3};
+	for (int32& Element : Generator_Elements(Array))
+		Element *= 10;
+	TestEqual(TEXT("Elements are yielded by reference"), Array, TArray<int32>{10, 20, 30});
+
+	const FGeneratorTestNode Root = {1, {{2, {{3, {}}}}, {4, {}}}};
+	TArray<int32> Visited;
+	for (const FGeneratorTestNode& Node : Generator_Walk(Root))
+		Visited.Add(Node.Value);
+	TestEqual(TEXT("Nested generators are flattened depth first"), Visited, TArray<int32>{1, 2, 3, 4});
+	return true;
+}
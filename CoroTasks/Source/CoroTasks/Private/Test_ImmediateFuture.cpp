@@ -38,7 +38,7 @@ CoroTasks::TTask<void> Test_ImmediateFuture::RunTest_Async(const FString Paramet
 	int32 Res = co_await ImmediateAction();
 
 	if (Res != 123)
-		throw FAsyncTestException(TEXT("Res != 123"));
+		ASYNC_TEST_FAIL(TEXT("Res != 123"));
 
 	UE_LOG(LogTemp, Log, TEXT("Finished! %i"), Res);
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroTasksTests.h"
+#include "Misc/ScopeExit.h"
+#include "TaskInterop.h"
+
+IMPLEMENT_ASYNC_AUTOMATION_TEST(Test_TaskInterop, "CoroTasks.TaskInterop", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter);
+
+CoroTasks::TTask<> Task_SetFlag(bool& bFlag)
+{
+	bFlag = co_await UE::Tasks::Launch(UE_SOURCE_LOCATION, [] { return true; });
+}
+
+CoroTasks::TTask<> Task_WaitEngineTask(UE::Tasks::FTask Task, bool& bResumed, bool& bDestroyed)
+{
+	ON_SCOPE_EXIT { bDestroyed = true; };
+	co_await Task;
+	bResumed = true;
+}
+
+CoroTasks::TTask<void> Test_TaskInterop::RunTest_Async(const FString Parameters)
+{
+	const int32 TaskResult = co_await UE::Tasks::Launch(UE_SOURCE_LOCATION, [] { return 42; });
+	if (TaskResult != 42)
+		ASYNC_TEST_FAIL(TEXT("UE::Tasks::TTask result is lost"));
+	if (!IsInGameThread())
+		ASYNC_TEST_FAIL(TEXT("Coroutine should continue on the game thread"));
+
+	bool bEventTaskExecuted = false;
+	co_await FFunctionGraphTask::CreateAndDispatchWhenReady([&bEventTaskExecuted] { bEventTaskExecuted = true; }, TStatId(), nullptr, ENamedThreads::AnyThread);
+	if (!bEventTaskExecuted)
+		ASYNC_TEST_FAIL(TEXT("Graph event is awaited before completion"));
+
+	TPromise<FString> Promise;
+	TFuture<FString> Future = Promise.GetFuture();
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [Promise = MoveTemp(Promise)] () mutable { Promise.SetValue(TEXT("Done")); });
+	const FString FutureResult = co_await MoveTemp(Future);
+	if (FutureResult != TEXT("Done"))
+		ASYNC_TEST_FAIL(TEXT("TFuture result is lost"));
+
+	bool bCoroutineFinished = false;
+	UE::Tasks::FTaskEvent Prerequisite = CoroTasks::AsPrerequisite(Task_SetFlag(bCoroutineFinished));
+	const bool bFinishedBefore = co_await UE::Tasks::Launch(UE_SOURCE_LOCATION, [&bCoroutineFinished] { return bCoroutineFinished; },
+		UE::Tasks::Prerequisites(Prerequisite));
+	if (!bFinishedBefore)
+		ASYNC_TEST_FAIL(TEXT("Coroutine task should be a prerequisite"));
+
+	// Completion that comes after the awaiting frame is cancelled doesn't resume it
+	UE::Tasks::FTaskEvent Gate(UE_SOURCE_LOCATION);
+	UE::Tasks::FTask Gated = UE::Tasks::Launch(UE_SOURCE_LOCATION, [] {}, UE::Tasks::Prerequisites(Gate));
+	bool bCancelledResumed = false;
+	bool bCancelledDestroyed = false;
+	CoroTasks::TTask<> Cancelled = Task_WaitEngineTask(Gated, bCancelledResumed, bCancelledDestroyed);
+	Cancelled.Launch();
+	Cancelled.Cancel();
+	if (!bCancelledDestroyed)
+		ASYNC_TEST_FAIL(TEXT("Cancel should destroy the frame"));
+
+	// Our resume is queued to the game thread after the one of the cancelled frame
+	Gate.Trigger();
+	co_await Gated;
+	if (bCancelledResumed)
+		ASYNC_TEST_FAIL(TEXT("Cancelled frame is resumed by the engine task"));
+}
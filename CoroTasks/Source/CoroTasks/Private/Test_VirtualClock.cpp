@@ -0,0 +1,89 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroTasksSubsystem.h"
+#include "CoroTasksTests.h"
+#include "Engine/Engine.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(Test_VirtualClock, "CoroTasks.VirtualClock",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+CoroTasks::TTask<> Task_Delays(UCoroTasksSubsystem& Subsystem, TArray<double>& WakeTimes, double Seconds)
+{
+	co_await Subsystem.CreateDelay(Seconds);
+	WakeTimes.Add(Subsystem.GetTime());
+	co_await Subsystem.CreateDelay(Seconds);
+	WakeTimes.Add(Subsystem.GetTime());
+}
+
+bool Test_VirtualClock::RunTest(const FString& Parameters)
+{
+	UCoroTasksSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UCoroTasksSubsystem>() : nullptr;
+	if (!TestNotNull(TEXT("Subsystem exists"), Subsystem))
+		return false;
+
+	Subsystem->SetVirtualClock(true);
+	const double StartTime = Subsystem->GetTime();
+
+	TArray<double> WakeTimes;
+	Task_Delays(*Subsystem, WakeTimes, 3600.0).Launch();
+	Task_Delays(*Subsystem, WakeTimes, 1800.0).Launch();
+
+	Subsystem->AdvanceVirtualClock(1000.0);
+	TestEqual(TEXT("Nothing is resumed before deadlines"), WakeTimes.Num(), 0);
+
+	Subsystem->AdvanceVirtualClock(6300.0);
+	TestEqual(TEXT("All delays are resumed"), WakeTimes.Num(), 4);
+	const TArray<double> Expected = {StartTime + 1800.0, StartTime + 3600.0, StartTime + 3600.0, StartTime + 7200.0};
+	for (int32 Index = 0; Index < FMath::Min(WakeTimes.Num(), Expected.Num()); ++Index)
+		TestEqual(TEXT("Delays wake at deadlines in order"), WakeTimes[Index], Expected[Index], 1e-6);
+
+	auto Future = Subsystem->CreateDelay(10.0);
+	TestTrue(TEXT("RunVirtualClock runs until the condition is met"),
+		Subsystem->RunVirtualClock([&Future] { return Future->await_ready(); }, 60.0));
+	TestFalse(TEXT("RunVirtualClock stops when nothing is scheduled"),
+		Subsystem->RunVirtualClock([] { return false; }, 60.0));
+
+	// Switching the clock off and on doesn't change the remaining time of a delay
+	auto Pending = Subsystem->CreateDelay(100.0);
+	Subsystem->AdvanceVirtualClock(60.0);
+	Subsystem->SetVirtualClock(false);
+	Subsystem->SetVirtualClock(true);
+	const double RestartTime = Subsystem->GetTime();
+	TestTrue(TEXT("Pending delay survives switching the clock"),
+		Subsystem->RunVirtualClock([&Pending] { return Pending->await_ready(); }, 1000.0));
+	TestEqual(TEXT("Pending delay keeps its remaining time"), Subsystem->GetTime() - RestartTime, 40.0, 1.0);
+
+	Subsystem->SetVirtualClock(false);
+	return true;
+}
+
+IMPLEMENT_ASYNC_AUTOMATION_TEST_VIRTUAL_CLOCK(Test_VirtualClockAsync, "CoroTasks.VirtualClockAsync",
+                                              EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+CoroTasks::TTask<void> Test_VirtualClockAsync::RunTest_Async(const FString Parameters)
+{
+	// A day of delays takes a single engine frame
+	for (int32 Hour = 0; Hour < 24; ++Hour)
+		co_await CoroTasks::Delay(3600.0);
+}
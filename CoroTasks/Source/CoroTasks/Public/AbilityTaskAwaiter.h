@@ -0,0 +1,196 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Abilities/GameplayAbility.h"
+#include "Abilities/Tasks/AbilityTask.h"
+#include "AsyncDelegate.h"
+#include "CoroScheduler.h"
+
+/**
+ * Tour to AbilityTask awaiter:
+ * Makes any UAbilityTask with dynamic multicast outcome delegates awaitable without subclassing it.
+ * Each outcome delegate is mapped to a result value (enum, TVariant or anything copyable), the first broadcast wins.
+ * If owning ability ends before any outcome, awaiter resolves to EndedResult. Task is activated by the await itself.
+ * Task destroyed without an outcome (EndTask) resolves it too when the task broadcasts its destruction through OnTaskDestroyed,
+ * other tasks resolve then only with the ability end.
+ * Outcome delegates are bound to pooled slots of shared UCoroDelegateProxy, so a wait has no tick, no timer and no subsystem entry
+ *	>>> UAbilityTask_WaitConfirmCancel* Task = UAbilityTask_WaitConfirmCancel::WaitConfirmCancel(this);
+ *	>>> const bool bConfirmed = co_await CoroTasks::AwaitAbilityTask(Task, false, {
+ *	>>>		{Task->OnConfirm, true},
+ *	>>>		{Task->OnCancel, false}});
+ */
+namespace CoroTasks
+{
+	template<typename ResultType>
+	struct TAbilityTaskOutcome
+	{
+		TAbilityTaskOutcome(FMulticastScriptDelegate& InDelegate, ResultType InResult)
+			: Delegate(&InDelegate)
+			, Result(MoveTemp(InResult))
+		{}
+
+		FMulticastScriptDelegate* Delegate;
+		ResultType Result;
+	};
+
+	template<typename ResultType>
+	class TAbilityTaskAwaiter
+	{
+	public:
+		using FOutcome = TAbilityTaskOutcome<ResultType>;
+
+		TAbilityTaskAwaiter(UAbilityTask* InTask, ResultType InEndedResult, std::initializer_list<FOutcome> InOutcomes, FSimpleMulticastDelegate* InOnTaskDestroyed = nullptr)
+			: Task(InTask)
+			, OnTaskDestroyed(InOnTaskDestroyed)
+			, Outcomes(InOutcomes)
+			, EndedResult(MoveTemp(InEndedResult))
+			, bSuspending(false)
+		{}
+
+		/** Lives in the awaiting frame and is bound by address */
+		TAbilityTaskAwaiter(const TAbilityTaskAwaiter&) = delete;
+		TAbilityTaskAwaiter& operator=(const TAbilityTaskAwaiter&) = delete;
+
+		/** Coroutine destroyed while waiting: stop listening, task keeps running */
+		~TAbilityTaskAwaiter()
+		{
+			Unbind();
+		}
+
+		bool await_ready()
+		{
+			if (!Task.IsValid() || Task->IsFinished())
+				Result.Emplace(EndedResult);
+			return Result.IsSet();
+		}
+
+		bool await_suspend(std::coroutine_handle<> Handle)
+		{
+			Continuation = FContinuation::Capture(Handle, COROTASKS_TEXT("TAbilityTaskAwaiter"));
+			for (int32 Index = 0; Index < Outcomes.Num(); ++Index)
+			{
+				Private::FDynamicDelegateSlot* Slot = Private::FDynamicDelegateSlot::Acquire(this, &TAbilityTaskAwaiter::OnOutcome, Index);
+				Slot->Bind(*Outcomes[Index].Delegate);
+				Slots.Add(Slot);
+			}
+
+			if (OnTaskDestroyed)
+			{
+				TaskDestroyedHandle = OnTaskDestroyed->AddLambda([this]
+				{
+					Finish(EndedResult);
+				});
+			}
+
+			UAbilityTask* TaskPtr = Task.Get();
+			if (UGameplayAbility* AbilityPtr = TaskPtr->Ability)
+			{
+				Ability = AbilityPtr;
+				AbilityEndedHandle = AbilityPtr->OnGameplayAbilityEnded.AddLambda([this](UGameplayAbility*)
+				{
+					Finish(EndedResult);
+				});
+			}
+
+			// Task may broadcast right in Activate, then we just don't suspend
+			bSuspending = true;
+			TaskPtr->ReadyForActivation();
+			bSuspending = false;
+			return !Result.IsSet();
+		}
+
+		ResultType await_resume()
+		{
+			return MoveTemp(Result.GetValue());
+		}
+
+	private:
+		static void OnOutcome(void* Owner, int32 OutcomeIndex, void* Parms)
+		{
+			TAbilityTaskAwaiter* Self = static_cast<TAbilityTaskAwaiter*>(Owner);
+			Self->Finish(Self->Outcomes[OutcomeIndex].Result);
+		}
+
+		void Finish(const ResultType& InResult)
+		{
+			if (Result.IsSet())
+				return;
+
+			Result.Emplace(InResult);
+			Unbind();
+			if (!bSuspending)
+				Continuation.Resume();
+		}
+
+		/** Garbage task is still reachable here, its delegates should be cleaned before slots go back to the pool */
+		void Unbind()
+		{
+			const bool bTaskAlive = Task.Get(true) != nullptr;
+			for (int32 Index = 0; Index < Slots.Num(); ++Index)
+			{
+				if (bTaskAlive)
+					Slots[Index]->Unbind(*Outcomes[Index].Delegate);
+				Slots[Index]->Release();
+			}
+			Slots.Reset();
+
+			if (TaskDestroyedHandle.IsValid())
+			{
+				if (bTaskAlive)
+					OnTaskDestroyed->Remove(TaskDestroyedHandle);
+				TaskDestroyedHandle.Reset();
+			}
+
+			if (AbilityEndedHandle.IsValid())
+			{
+				if (UGameplayAbility* AbilityPtr = Ability.Get(true))
+					AbilityPtr->OnGameplayAbilityEnded.Remove(AbilityEndedHandle);
+				AbilityEndedHandle.Reset();
+			}
+		}
+
+		TWeakObjectPtr<UAbilityTask> Task;
+		/** Member of Task, touched only while it's alive */
+		FSimpleMulticastDelegate* OnTaskDestroyed;
+		TWeakObjectPtr<UGameplayAbility> Ability;
+		TArray<FOutcome, TInlineAllocator<4>> Outcomes;
+		ResultType EndedResult;
+		TOptional<ResultType> Result;
+		TArray<Private::FDynamicDelegateSlot*, TInlineAllocator<4>> Slots;
+		FDelegateHandle AbilityEndedHandle;
+		FDelegateHandle TaskDestroyedHandle;
+		FContinuation Continuation;
+		bool bSuspending;
+	};
+
+	/** See TAbilityTaskAwaiter. Delegates should be members of Task */
+	template<typename ResultType>
+	TAbilityTaskAwaiter<ResultType> AwaitAbilityTask(UAbilityTask* Task, ResultType EndedResult, std::initializer_list<TAbilityTaskOutcome<ResultType>> Outcomes,
+		FSimpleMulticastDelegate* OnTaskDestroyed = nullptr)
+	{
+		return TAbilityTaskAwaiter<ResultType>(Task, MoveTemp(EndedResult), Outcomes, OnTaskDestroyed);
+	}
+}
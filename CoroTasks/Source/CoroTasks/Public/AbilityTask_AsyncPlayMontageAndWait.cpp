@@ -22,27 +22,11 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbilityTask_AsyncPlayMontageAndWait.h"
-#include "CoroTasksSubsystem.h"
 #include "AbilitySystemGlobals.h"
+#include "Animation/AnimInstance.h"
+#include "CoroTasks.h"
 
 
-UAbilityTask_AsyncPlayMontageAndWait::UAbilityTask_AsyncPlayMontageAndWait()
-{
-	bTickingTask = true;
-	
-}
-
-void UAbilityTask_AsyncPlayMontageAndWait::TickTask(float DeltaTime)
-{
-	Super::TickTask(DeltaTime);
-}
-
-void UAbilityTask_AsyncPlayMontageAndWait::OnDestroy(bool bInOwnerFinished)
-{
-	Super::OnDestroy(bInOwnerFinished);
-	FinishWithResult_IfNothing(EPlayMontageAndWaitResult::Destroyed);
-}
-
 TWeakObjectPtr<UAbilityTask_AsyncPlayMontageAndWait> UAbilityTask_AsyncPlayMontageAndWait::Create(UGameplayAbility* OwningAbility,
                                                                                                   FName TaskInstanceName, UAnimMontage* MontageToPlay, float Rate, FName StartSection, bool bStopWhenAbilityEnds,
                                                                                                   float AnimRootMotionTranslationScale, float StartTimeSeconds)
@@ -57,69 +41,137 @@ TWeakObjectPtr<UAbilityTask_AsyncPlayMontageAndWait> UAbilityTask_AsyncPlayMonta
 	MyObj->AnimRootMotionTranslationScale = AnimRootMotionTranslationScale;
 	MyObj->bStopWhenAbilityEnds = bStopWhenAbilityEnds;
 	MyObj->StartTimeSeconds = StartTimeSeconds;
-
-	MyObj->OnCompleted.AddDynamic(MyObj, &ThisClass::AyncCompleted);
-	MyObj->OnBlendOut.AddDynamic(MyObj, &ThisClass::AyncBlendOut);
-	MyObj->OnInterrupted.AddDynamic(MyObj, &ThisClass::AyncInterrupted);
-	MyObj->OnCancelled.AddDynamic(MyObj, &ThisClass::AyncCancelled);
-
-	FTimerHandle TH;
-	const float MontageDuration = MontageToPlay->GetPlayLength() * (Rate >= 0 ? Rate : 1) + 0.1;
-	MyObj->GetWorld()->GetTimerManager().SetTimer(TH, MyObj, &ThisClass::AsyncTimeout, MontageDuration);
-
-#if WITH_CPP_COROUTINES
-	MyObj->bFinished = false;
-#endif
-	
 	
 	return MyObj;
 }
 
-void UAbilityTask_AsyncPlayMontageAndWait::AyncCompleted()
+void UAbilityTask_AsyncPlayMontageAndWait::Activate()
 {
-	FinishWithResult_IfNothing(EPlayMontageAndWaitResult::Completed);
+	Super::Activate();
+
+	// Failed play already finished the stream through OnCancelled
+	if (!Events || Events->IsClosed())
+		return;
+
+	const FGameplayAbilityActorInfo* ActorInfo = Ability ? Ability->GetCurrentActorInfo() : nullptr;
+	UAnimInstance* AnimInstance = ActorInfo ? ActorInfo->GetAnimInstance() : nullptr;
+	const FAnimMontageInstance* MontageInstance = AnimInstance ? AnimInstance->GetActiveInstanceForMontage(MontageToPlay) : nullptr;
+	if (!MontageInstance)
+		return;
+
+	StreamAnimInstance = AnimInstance;
+	StreamMontageInstanceID = MontageInstance->GetInstanceID();
+	AnimInstance->OnPlayMontageNotifyBegin.AddDynamic(this, &ThisClass::StreamNotifyBegin);
+	AnimInstance->OnPlayMontageNotifyEnd.AddDynamic(this, &ThisClass::StreamNotifyEnd);
+	PushSectionIfChanged();
 }
 
-void UAbilityTask_AsyncPlayMontageAndWait::AyncBlendOut()
+void UAbilityTask_AsyncPlayMontageAndWait::OnDestroy(bool bInOwnerFinished)
 {
-	FinishWithResult_IfNothing(EPlayMontageAndWaitResult::BlendOut);
+	FinishStream(EPlayMontageAndWaitResult::Destroyed);
+	OnTaskDestroyed.Broadcast();
+	Super::OnDestroy(bInOwnerFinished);
 }
 
-void UAbilityTask_AsyncPlayMontageAndWait::FinishWithResult_IfNothing(EPlayMontageAndWaitResult Result)
+TSharedRef<CoroTasks::TAsyncChannel<FMontageEvent>> UAbilityTask_AsyncPlayMontageAndWait::StreamEvents(uint32 Capacity)
 {
-#if WITH_CPP_COROUTINES
-	if (Future.IsSet() && !bFinished)
+	check(!Events);
+	// One more slot is kept for Finished
+	TSharedRef<CoroTasks::TAsyncChannel<FMontageEvent>> Channel = MakeShared<CoroTasks::TAsyncChannel<FMontageEvent>>(Capacity + 1);
+	Events = Channel;
+	OnBlendOut.AddDynamic(this, &ThisClass::StreamBlendOut);
+	OnCompleted.AddDynamic(this, &ThisClass::StreamCompleted);
+	OnInterrupted.AddDynamic(this, &ThisClass::StreamInterrupted);
+	OnCancelled.AddDynamic(this, &ThisClass::StreamCancelled);
+	ReadyForActivation();
+	return Channel;
+}
+
+void UAbilityTask_AsyncPlayMontageAndWait::StreamNotifyBegin(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload)
+{
+	if (BranchingPointPayload.MontageInstanceID == StreamMontageInstanceID)
 	{
-		bFinished = true;
-		(*Future)->SetResult(Result);
-		Future.Reset();
+		PushSectionIfChanged();
+		PushEvent(EMontageEventType::NotifyBegin, NotifyName);
 	}
-#endif
 }
 
-void UAbilityTask_AsyncPlayMontageAndWait::AyncInterrupted()
+void UAbilityTask_AsyncPlayMontageAndWait::StreamNotifyEnd(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload)
 {
-	FinishWithResult_IfNothing(EPlayMontageAndWaitResult::Interrupted);
+	if (BranchingPointPayload.MontageInstanceID == StreamMontageInstanceID)
+	{
+		PushSectionIfChanged();
+		PushEvent(EMontageEventType::NotifyEnd, NotifyName);
+	}
+}
 
+void UAbilityTask_AsyncPlayMontageAndWait::StreamBlendOut()
+{
+	PushSectionIfChanged();
+	PushEvent(EMontageEventType::BlendOut, NAME_None);
+}
+
+void UAbilityTask_AsyncPlayMontageAndWait::StreamCompleted()
+{
+	FinishStream(EPlayMontageAndWaitResult::Completed);
 }
 
-void UAbilityTask_AsyncPlayMontageAndWait::AyncCancelled()
+void UAbilityTask_AsyncPlayMontageAndWait::StreamInterrupted()
 {
-	FinishWithResult_IfNothing(EPlayMontageAndWaitResult::Cancelled);
+	FinishStream(EPlayMontageAndWaitResult::Interrupted);
 }
 
-void UAbilityTask_AsyncPlayMontageAndWait::AsyncTimeout()
+void UAbilityTask_AsyncPlayMontageAndWait::StreamCancelled()
 {
-	FinishWithResult_IfNothing(EPlayMontageAndWaitResult::Timeout);
+	FinishStream(EPlayMontageAndWaitResult::Cancelled);
+}
+
+void UAbilityTask_AsyncPlayMontageAndWait::PushEvent(EMontageEventType Type, FName Name, EPlayMontageAndWaitResult Result)
+{
+	// Task is the only producer, so the reserved slot can't be taken by anybody else
+	const bool bReserved = Type != EMontageEventType::Finished && Events->Num() + 1 >= Events->GetCapacity();
+	if (bReserved || !Events->TrySend(FMontageEvent{Type, Name, Result}))
+		UE_LOG(LogCoroTasks, Warning, TEXT("%s: montage event %s is dropped, receiver lags behind"), *GetInstanceName().ToString(), *Name.ToString());
+}
+
+void UAbilityTask_AsyncPlayMontageAndWait::PushSectionIfChanged()
+{
+	UAnimInstance* AnimInstance = StreamAnimInstance.Get();
+	if (!AnimInstance)
+		return;
+
+	const FName Section = AnimInstance->Montage_GetCurrentSection(MontageToPlay);
+	if (Section != StreamSection)
+	{
+		StreamSection = Section;
+		PushEvent(EMontageEventType::SectionChanged, Section);
+	}
+}
+
+void UAbilityTask_AsyncPlayMontageAndWait::FinishStream(EPlayMontageAndWaitResult Result)
+{
+	if (!Events || Events->IsClosed())
+		return;
+
+	if (UAnimInstance* AnimInstance = StreamAnimInstance.Get())
+	{
+		AnimInstance->OnPlayMontageNotifyBegin.RemoveDynamic(this, &ThisClass::StreamNotifyBegin);
+		AnimInstance->OnPlayMontageNotifyEnd.RemoveDynamic(this, &ThisClass::StreamNotifyEnd);
+	}
+	StreamAnimInstance.Reset();
+
+	PushEvent(EMontageEventType::Finished, NAME_None, Result);
+	Events->Close();
 }
 
 #if WITH_CPP_COROUTINES
-CoroTasks::TFuture<EPlayMontageAndWaitResult>& UAbilityTask_AsyncPlayMontageAndWait::operator co_await()
+CoroTasks::TAbilityTaskAwaiter<EPlayMontageAndWaitResult> UAbilityTask_AsyncPlayMontageAndWait::operator co_await()
 {
-	ReadyForActivation();
-	auto& LatentAction = GEngine->GetEngineSubsystem<UCoroTasksSubsystem>()->CreateLatentAction<EPlayMontageAndWaitResult>();
-	auto MyFuture = StaticCastSharedRef<CoroTasks::TFuture<EPlayMontageAndWaitResult>>(LatentAction.Future);
-	Future.Emplace(MyFuture);
-	return MyFuture.Get();
+	return CoroTasks::AwaitAbilityTask(this, EPlayMontageAndWaitResult::Destroyed, {
+		{OnCompleted, EPlayMontageAndWaitResult::Completed},
+		{OnBlendOut, EPlayMontageAndWaitResult::BlendOut},
+		{OnInterrupted, EPlayMontageAndWaitResult::Interrupted},
+		{OnCancelled, EPlayMontageAndWaitResult::Cancelled}},
+		&OnTaskDestroyed);
 }
-#endif
\ No newline at end of file
+#endif
@@ -25,6 +25,8 @@
 
 #include "CoreMinimal.h"
 #include "Abilities/Tasks/AbilityTask_PlayMontageAndWait.h"
+#include "AbilityTaskAwaiter.h"
+#include "AsyncChannel.h"
 #include "Coroutine.h"
 #include "UObject/Object.h"
 #include "AbilityTask_AsyncPlayMontageAndWait.generated.h"
@@ -35,21 +37,49 @@ enum class EPlayMontageAndWaitResult : uint8
 	BlendOut,
 	Interrupted,
 	Cancelled,
+	/** Is not produced anymore: outcome delegates or ability end always resolve the wait */
 	Timeout,
 	Destroyed,
 };
 
+enum class EMontageEventType : uint8
+{
+	NotifyBegin,
+	NotifyEnd,
+	/** Reported at the next event boundary (no tick), put a notify at section start to observe it right in time */
+	SectionChanged,
+	BlendOut,
+	/** Last event of the stream, carries the result */
+	Finished,
+};
+
+struct FMontageEvent
+{
+	EMontageEventType Type;
+	/** Notify or section name */
+	FName Name;
+	EPlayMontageAndWaitResult Result;
+};
+
 /**
  * Tour to AbilityTasks:
  * This class is very similar to it's ancestor, but with some differences
  *	1. Instead of UAbilityTask_AsyncPlayMontageAndWait::CreatePlayMontageAndWaitProxy we use
  *		UAbilityTask_AsyncPlayMontageAndWait::Create that returns templated object (may be weak) pointer
- *	2. We adds Future object to resume continuation
- *	3. We use co_await operator to add coroutine support (it automatically calls ReadyForActivation)
- *		In co_await operator we should create Future object that will be managed by UCoroTasksSubsystem
+ *	2. We use co_await operator to add coroutine support (it automatically calls ReadyForActivation)
+ *		Outcome delegates are mapped to EPlayMontageAndWaitResult through TAbilityTaskAwaiter, see AbilityTaskAwaiter.h.
+ *		Task doesn't tick and wait doesn't need any timer or subsystem entry
+ *	
+ *	3. Instead of one task per notify, StreamEvents gives notify, section and blend events of this montage through a channel.
+ *		Only notify begin/end delegates of the anim instance are bound, and only while the stream is open
  *	
  *	Use case:
  *	>>> EPlayMontageAndWaitResult Result = co_await UAbilityTask_AsyncPlayMontageAndWait::Create(MyAbility, TEXT("MyTask"), MyMontage);
+ *
+ *	>>> auto Events = UAbilityTask_AsyncPlayMontageAndWait::Create(MyAbility, TEXT("Combo"), ComboMontage)->StreamEvents();
+ *	>>> while (TOptional<FMontageEvent> Event = co_await Events->Receive())
+ *	>>>		if (Event->Type == EMontageEventType::NotifyBegin && Event->Name == TEXT("Hit"))
+ *	>>>			ApplyHit();
  */
 UCLASS()
 class COROTASKS_API UAbilityTask_AsyncPlayMontageAndWait : public UAbilityTask_PlayMontageAndWait
@@ -57,39 +87,53 @@ class COROTASKS_API UAbilityTask_AsyncPlayMontageAndWait : public UAbilityTask_P
 	GENERATED_BODY()
 
 public:
-	UAbilityTask_AsyncPlayMontageAndWait();
-	
-	virtual void TickTask(float DeltaTime) override;
-	virtual void OnDestroy(bool bInOwnerFinished) override;
-	
 	static TWeakObjectPtr<ThisClass> Create(UGameplayAbility* OwningAbility,
 		FName TaskInstanceName, UAnimMontage* MontageToPlay, float Rate = 1.f,
 		FName StartSection = NAME_None, bool bStopWhenAbilityEnds = true,
 		float AnimRootMotionTranslationScale = 1.f, float StartTimeSeconds = 0.f);
 
-	
+	virtual void Activate() override;
+	virtual void OnDestroy(bool bInOwnerFinished) override;
+
+	/**
+	 * Activates the task (instead of co_await) and returns its event stream, channel is closed after Finished event.
+	 * Events are dropped with warning if receiver lags more than Capacity, Finished has a reserved slot and is always delivered
+	 */
+	TSharedRef<CoroTasks::TAsyncChannel<FMontageEvent>> StreamEvents(uint32 Capacity = 16);
+
+	/** Broadcast from OnDestroy, so co_await resolves to Destroyed when the task ends without an outcome */
+	FSimpleMulticastDelegate OnTaskDestroyed;
+
+#if WITH_CPP_COROUTINES
+	CoroTasks::TAbilityTaskAwaiter<EPlayMontageAndWaitResult> operator co_await();
+#endif
+
+private:
 	UFUNCTION()
-	void AyncCompleted();
-	
+	void StreamNotifyBegin(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload);
+
 	UFUNCTION()
-	void AyncBlendOut();
+	void StreamNotifyEnd(FName NotifyName, const FBranchingPointNotifyPayload& BranchingPointPayload);
 
-	void FinishWithResult_IfNothing(EPlayMontageAndWaitResult Result);
-	
 	UFUNCTION()
-	void AyncInterrupted();
-	
+	void StreamBlendOut();
+
 	UFUNCTION()
-	void AyncCancelled();
+	void StreamCompleted();
 
 	UFUNCTION()
-	void AsyncTimeout();
+	void StreamInterrupted();
 
-#if WITH_CPP_COROUTINES
-	bool bFinished;
-	
-	TOptional<TSharedRef<CoroTasks::TFuture<EPlayMontageAndWaitResult>>> Future;
-	
-	CoroTasks::TFuture<EPlayMontageAndWaitResult>& operator co_await();
-#endif
+	UFUNCTION()
+	void StreamCancelled();
+
+	void PushEvent(EMontageEventType Type, FName Name, EPlayMontageAndWaitResult Result = EPlayMontageAndWaitResult::Completed);
+	void PushSectionIfChanged();
+	void FinishStream(EPlayMontageAndWaitResult Result);
+
+	/** Shared with the receiver, which may outlive the task */
+	TSharedPtr<CoroTasks::TAsyncChannel<FMontageEvent>> Events;
+	TWeakObjectPtr<UAnimInstance> StreamAnimInstance;
+	int32 StreamMontageInstanceID = INDEX_NONE;
+	FName StreamSection;
 };
@@ -0,0 +1,155 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncAbilitySystem.h"
+#include "AbilitySystemComponent.h"
+
+using namespace CoroTasks;
+
+namespace CoroTasks::Private
+{
+	/** Nodes are never freed, pool size is the peak count of simultaneous waits */
+	static TArray<FAbilitySystemListener*> FreeAbilitySystemListeners;
+}
+
+Private::FAbilitySystemListener* Private::FAbilitySystemListener::Acquire(UAbilitySystemComponent* AbilitySystem, EKind Kind, void* Owner, FCallback Callback)
+{
+	check(IsInGameThread());
+	FAbilitySystemListener* Listener = Private::FreeAbilitySystemListeners.IsEmpty() ? new FAbilitySystemListener() : Private::FreeAbilitySystemListeners.Pop(false);
+	Listener->AbilitySystem = AbilitySystem;
+	Listener->Kind = Kind;
+	Listener->Owner = Owner;
+	Listener->Callback = Callback;
+	++Listener->Serial;
+	return Listener;
+}
+
+Private::FAbilitySystemListener* Private::FAbilitySystemListener::BindGameplayEvent(UAbilitySystemComponent* AbilitySystem, FGameplayTag Tag, void* Owner, FCallback Callback)
+{
+	FAbilitySystemListener* Listener = Acquire(AbilitySystem, EKind::GameplayEvent, Owner, Callback);
+	Listener->Tag = Tag;
+	// Container delegates match child event tags, GenericGameplayEventCallbacks are exact match only
+	Listener->Handle = AbilitySystem->AddGameplayEventTagContainerDelegate(FGameplayTagContainer(Tag),
+		FGameplayEventTagMulticastDelegate::FDelegate::CreateRaw(Listener, &FAbilitySystemListener::OnGameplayEvent, Listener->Serial));
+	return Listener;
+}
+
+Private::FAbilitySystemListener* Private::FAbilitySystemListener::BindTagCount(UAbilitySystemComponent* AbilitySystem, FGameplayTag Tag, void* Owner, FCallback Callback)
+{
+	FAbilitySystemListener* Listener = Acquire(AbilitySystem, EKind::TagCount, Owner, Callback);
+	Listener->Tag = Tag;
+	Listener->Handle = AbilitySystem->RegisterGameplayTagEvent(Tag, EGameplayTagEventType::NewOrRemoved).AddRaw(Listener, &FAbilitySystemListener::OnTagCountChanged);
+	return Listener;
+}
+
+Private::FAbilitySystemListener* Private::FAbilitySystemListener::BindAttribute(UAbilitySystemComponent* AbilitySystem, const FGameplayAttribute& Attribute, void* Owner, FCallback Callback)
+{
+	FAbilitySystemListener* Listener = Acquire(AbilitySystem, EKind::Attribute, Owner, Callback);
+	Listener->Attribute = Attribute;
+	Listener->Handle = AbilitySystem->GetGameplayAttributeValueChangeDelegate(Attribute).AddRaw(Listener, &FAbilitySystemListener::OnAttributeChanged);
+	return Listener;
+}
+
+void Private::FAbilitySystemListener::Release()
+{
+	check(IsInGameThread());
+	// Removal is safe during broadcast: invocation list is compacted after it
+	if (UAbilitySystemComponent* AbilitySystemPtr = AbilitySystem.Get(true))
+	{
+		switch (Kind)
+		{
+		case EKind::GameplayEvent:
+			AbilitySystemPtr->RemoveGameplayEventTagContainerDelegate(FGameplayTagContainer(Tag), Handle);
+			break;
+		case EKind::TagCount:
+			AbilitySystemPtr->UnregisterGameplayTagEvent(Handle, Tag, EGameplayTagEventType::NewOrRemoved);
+			break;
+		case EKind::Attribute:
+			AbilitySystemPtr->GetGameplayAttributeValueChangeDelegate(Attribute).Remove(Handle);
+			break;
+		}
+	}
+
+	AbilitySystem.Reset();
+	Handle.Reset();
+	Owner = nullptr;
+	Callback = nullptr;
+	Private::FreeAbilitySystemListeners.Push(this);
+}
+
+void Private::FAbilitySystemListener::OnGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload, uint32 BindSerial)
+{
+	if (BindSerial == Serial && Callback)
+		Callback(Owner, Payload);
+}
+
+void Private::FAbilitySystemListener::OnTagCountChanged(const FGameplayTag InTag, int32 NewCount)
+{
+	Callback(Owner, &NewCount);
+}
+
+void Private::FAbilitySystemListener::OnAttributeChanged(const FOnAttributeChangeData& Data)
+{
+	Callback(Owner, &Data);
+}
+
+
+void FWaitGameplayEventAwaiter::OnEvent(void* Owner, const void* InPayload)
+{
+	FWaitGameplayEventAwaiter* Self = static_cast<FWaitGameplayEventAwaiter*>(Owner);
+	if (InPayload)
+		Self->Payload = *static_cast<const FGameplayEventData*>(InPayload);
+	Self->Finish();
+}
+
+bool FWaitTagAwaiter::await_ready() const
+{
+	return AbilitySystem == nullptr || AbilitySystem->HasMatchingGameplayTag(Tag) == bPresent;
+}
+
+void FWaitTagAwaiter::OnTagCountChanged(void* Owner, const void* InNewCount)
+{
+	FWaitTagAwaiter* Self = static_cast<FWaitTagAwaiter*>(Owner);
+	if ((*static_cast<const int32*>(InNewCount) > 0) == Self->bPresent)
+		Self->Finish();
+}
+
+bool FWaitAttributeAtLeastAwaiter::await_ready()
+{
+	if (AbilitySystem == nullptr)
+		return true;
+
+	Value = AbilitySystem->GetNumericAttribute(Attribute);
+	return Value >= Threshold;
+}
+
+void FWaitAttributeAtLeastAwaiter::OnAttributeChanged(void* Owner, const void* InData)
+{
+	FWaitAttributeAtLeastAwaiter* Self = static_cast<FWaitAttributeAtLeastAwaiter*>(Owner);
+	const float NewValue = static_cast<const FOnAttributeChangeData*>(InData)->NewValue;
+	if (NewValue >= Self->Threshold)
+	{
+		Self->Value = NewValue;
+		Self->Finish();
+	}
+}
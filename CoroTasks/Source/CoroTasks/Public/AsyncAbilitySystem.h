@@ -0,0 +1,238 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Abilities/GameplayAbilityTypes.h"
+#include "AttributeSet.h"
+#include "CoroScheduler.h"
+#include "GameplayTagContainer.h"
+
+class UAbilitySystemComponent;
+
+/**
+ * Tour to ability system awaitables:
+ * Waits directly on UAbilitySystemComponent delegates, without ability task UObject per wait.
+ * Each suspended wait holds one pooled plain listener node, the node is unbound and returned to the pool
+ * when the coroutine is resumed or when the awaiting frame is destroyed (cancelled)
+ *	1. WaitGameplayEvent	- returns event payload, parent tags match like for ability triggers
+ *	2. WaitTagAdded			- returns immediately if tag is already present
+ *	3. WaitTagRemoved		- returns immediately if tag is absent
+ *	4. WaitAttributeAtLeast	- returns attribute value once it reaches threshold
+ *
+ * Use case:
+ *	>>> FGameplayEventData Hit = co_await CoroTasks::WaitGameplayEvent(ASC, TAG_Event_Hit);
+ *	>>> co_await CoroTasks::WaitTagRemoved(ASC, TAG_State_Stunned);
+ *	>>> float Rage = co_await CoroTasks::WaitAttributeAtLeast(ASC, UMyAttributeSet::GetRageAttribute(), 100.f);
+ */
+namespace CoroTasks
+{
+	namespace Private
+	{
+		/** Plain (not GC) binding of one wait. Game thread only, like the ability system itself */
+		class COROTASKS_API FAbilitySystemListener
+		{
+		public:
+			/** Payload is const FGameplayEventData* for events, const int32* (new count) for tags and const FOnAttributeChangeData* for attributes */
+			using FCallback = void(*)(void* Owner, const void* Payload);
+
+			static FAbilitySystemListener* BindGameplayEvent(UAbilitySystemComponent* AbilitySystem, FGameplayTag Tag, void* Owner, FCallback Callback);
+			static FAbilitySystemListener* BindTagCount(UAbilitySystemComponent* AbilitySystem, FGameplayTag Tag, void* Owner, FCallback Callback);
+			static FAbilitySystemListener* BindAttribute(UAbilitySystemComponent* AbilitySystem, const FGameplayAttribute& Attribute, void* Owner, FCallback Callback);
+
+			/** Unbinds delegate (if ability system is still alive) and returns node to the pool */
+			void Release();
+
+		private:
+			enum class EKind : uint8
+			{
+				GameplayEvent,
+				TagCount,
+				Attribute,
+			};
+
+			static FAbilitySystemListener* Acquire(UAbilitySystemComponent* AbilitySystem, EKind Kind, void* Owner, FCallback Callback);
+
+			/** BindSerial filters out calls of a released binding: event delegates are copied before broadcast */
+			void OnGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload, uint32 BindSerial);
+			void OnTagCountChanged(const FGameplayTag InTag, int32 NewCount);
+			void OnAttributeChanged(const FOnAttributeChangeData& Data);
+
+			TWeakObjectPtr<UAbilitySystemComponent> AbilitySystem;
+			FGameplayTag Tag;
+			FGameplayAttribute Attribute;
+			FDelegateHandle Handle;
+			void* Owner = nullptr;
+			FCallback Callback = nullptr;
+			/** Changes on each bind, the pool reuses nodes */
+			uint32 Serial = 0;
+			EKind Kind = EKind::GameplayEvent;
+		};
+
+		class FAbilitySystemAwaiter_Base
+		{
+		public:
+			explicit FAbilitySystemAwaiter_Base(UAbilitySystemComponent* InAbilitySystem)
+				: AbilitySystem(InAbilitySystem)
+				, Listener(nullptr)
+			{
+				ensureMsgf(AbilitySystem, TEXT("Waiting on null ability system, wait is resumed immediately"));
+			}
+
+			/** Lives in the awaiting frame and is bound by address */
+			FAbilitySystemAwaiter_Base(const FAbilitySystemAwaiter_Base&) = delete;
+			FAbilitySystemAwaiter_Base& operator=(const FAbilitySystemAwaiter_Base&) = delete;
+
+			~FAbilitySystemAwaiter_Base()
+			{
+				if (Listener)
+					Listener->Release();
+			}
+
+		protected:
+			void Finish()
+			{
+				Listener->Release();
+				Listener = nullptr;
+				Continuation.Resume();
+			}
+
+			/** Only valid until suspension, later the listener keeps weak pointer */
+			UAbilitySystemComponent* AbilitySystem;
+			FAbilitySystemListener* Listener;
+			FContinuation Continuation;
+		};
+	}
+
+	class COROTASKS_API FWaitGameplayEventAwaiter : public Private::FAbilitySystemAwaiter_Base
+	{
+	public:
+		FWaitGameplayEventAwaiter(UAbilitySystemComponent* InAbilitySystem, FGameplayTag InTag)
+			: FAbilitySystemAwaiter_Base(InAbilitySystem)
+			, Tag(InTag)
+		{}
+
+		bool await_ready() const
+		{
+			return AbilitySystem == nullptr;
+		}
+
+		void await_suspend(std::coroutine_handle<> Handle)
+		{
+			Continuation = FContinuation::Capture(Handle, TEXT("WaitGameplayEvent"));
+			Listener = Private::FAbilitySystemListener::BindGameplayEvent(AbilitySystem, Tag, this, &FWaitGameplayEventAwaiter::OnEvent);
+		}
+
+		FGameplayEventData await_resume()
+		{
+			return MoveTemp(Payload);
+		}
+
+	private:
+		static void OnEvent(void* Owner, const void* InPayload);
+
+		FGameplayTag Tag;
+		FGameplayEventData Payload;
+	};
+
+	class COROTASKS_API FWaitTagAwaiter : public Private::FAbilitySystemAwaiter_Base
+	{
+	public:
+		FWaitTagAwaiter(UAbilitySystemComponent* InAbilitySystem, FGameplayTag InTag, bool bInPresent)
+			: FAbilitySystemAwaiter_Base(InAbilitySystem)
+			, Tag(InTag)
+			, bPresent(bInPresent)
+		{}
+
+		bool await_ready() const;
+
+		void await_suspend(std::coroutine_handle<> Handle)
+		{
+			Continuation = FContinuation::Capture(Handle, bPresent ? TEXT("WaitTagAdded") : TEXT("WaitTagRemoved"));
+			Listener = Private::FAbilitySystemListener::BindTagCount(AbilitySystem, Tag, this, &FWaitTagAwaiter::OnTagCountChanged);
+		}
+
+		void await_resume()
+		{
+		}
+
+	private:
+		static void OnTagCountChanged(void* Owner, const void* InNewCount);
+
+		FGameplayTag Tag;
+		bool bPresent;
+	};
+
+	class COROTASKS_API FWaitAttributeAtLeastAwaiter : public Private::FAbilitySystemAwaiter_Base
+	{
+	public:
+		FWaitAttributeAtLeastAwaiter(UAbilitySystemComponent* InAbilitySystem, const FGameplayAttribute& InAttribute, float InThreshold)
+			: FAbilitySystemAwaiter_Base(InAbilitySystem)
+			, Attribute(InAttribute)
+			, Threshold(InThreshold)
+			, Value(0.f)
+		{}
+
+		bool await_ready();
+
+		void await_suspend(std::coroutine_handle<> Handle)
+		{
+			Continuation = FContinuation::Capture(Handle, TEXT("WaitAttributeAtLeast"));
+			Listener = Private::FAbilitySystemListener::BindAttribute(AbilitySystem, Attribute, this, &FWaitAttributeAtLeastAwaiter::OnAttributeChanged);
+		}
+
+		float await_resume() const
+		{
+			return Value;
+		}
+
+	private:
+		static void OnAttributeChanged(void* Owner, const void* InData);
+
+		FGameplayAttribute Attribute;
+		float Threshold;
+		float Value;
+	};
+
+	/** Resumes on the next gameplay event with Tag (or its child tag) sent to AbilitySystem */
+	inline FWaitGameplayEventAwaiter WaitGameplayEvent(UAbilitySystemComponent* AbilitySystem, FGameplayTag Tag)
+	{
+		return FWaitGameplayEventAwaiter(AbilitySystem, Tag);
+	}
+
+	inline FWaitTagAwaiter WaitTagAdded(UAbilitySystemComponent* AbilitySystem, FGameplayTag Tag)
+	{
+		return FWaitTagAwaiter(AbilitySystem, Tag, true);
+	}
+
+	inline FWaitTagAwaiter WaitTagRemoved(UAbilitySystemComponent* AbilitySystem, FGameplayTag Tag)
+	{
+		return FWaitTagAwaiter(AbilitySystem, Tag, false);
+	}
+
+	inline FWaitAttributeAtLeastAwaiter WaitAttributeAtLeast(UAbilitySystemComponent* AbilitySystem, const FGameplayAttribute& Attribute, float Threshold)
+	{
+		return FWaitAttributeAtLeastAwaiter(AbilitySystem, Attribute, Threshold);
+	}
+}
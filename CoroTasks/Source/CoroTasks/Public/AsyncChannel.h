@@ -0,0 +1,425 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "AsyncSync.h"
+#include "Templates/TypeCompatibleBytes.h"
+
+/**
+ * Tour to channels:
+ * TAsyncChannel is a bounded queue between coroutines (producers can live on any thread).
+ * Send suspends the producer when channel is full, Receive suspends the consumer when channel is empty,
+ * so memory of pipeline stays bounded by channel capacity. Capacity is exact, it isn't rounded up.
+ * Suspended senders deliver in order of Send: a new Send waits behind them even if a slot is free.
+ * Cancelled coroutines leave the channel, a value that was already handed to a cancelled receiver is lost
+ *
+ * Ring buffer is lock-free; lock is taken only when somebody has to be parked or woken
+ *
+ * Use case:
+ *	>>> CoroTasks::TAsyncChannel<FDecodedChunk> Chunks(64);
+ *	>>>
+ *	>>> CoroTasks::TTask<> Decode()			// on worker thread
+ *	>>> {
+ *	>>>		while (...)
+ *	>>>			co_await Chunks.Send(DecodeNext());
+ *	>>>		Chunks.Close();
+ *	>>> }
+ *	>>>
+ *	>>> CoroTasks::TTask<> Spawn()			// on game thread
+ *	>>> {
+ *	>>>		while (TOptional<FDecodedChunk> Chunk = co_await Chunks.Receive())
+ *	>>>			SpawnFrom(*Chunk);
+ *	>>> }
+ */
+namespace CoroTasks
+{
+	template<typename T>
+	class TAsyncChannel
+	{
+	public:
+		explicit TAsyncChannel(uint32 InCapacity)
+			: Capacity(FMath::Max(InCapacity, 1u))
+			, NumCells(FMath::Max(Capacity, 2u))
+			, Cells(MakeUnique<FCell[]>(NumCells))
+			, EnqueuePos(0)
+			, DequeuePos(0)
+			, NumWaitingSenders(0)
+			, NumWaitingReceivers(0)
+			, bClosed(false)
+		{
+			for (uint32 Index = 0; Index < NumCells; ++Index)
+				Cells[Index].Sequence.store(Index, std::memory_order_relaxed);
+		}
+
+		~TAsyncChannel()
+		{
+			ensureMsgf(SendWaiters.IsEmpty() && ReceiveWaiters.IsEmpty(), TEXT("Channel destroyed while coroutines are waiting for it"));
+			TOptional<T> Value;
+			while (TryPop(Value))
+				Value.Reset();
+		}
+
+		TAsyncChannel(const TAsyncChannel&) = delete;
+		TAsyncChannel& operator=(const TAsyncChannel&) = delete;
+
+		struct FSendAwaiter : Private::FAsyncWaiter
+		{
+			FSendAwaiter(TAsyncChannel& InChannel, T&& InValue)
+				: Channel(InChannel)
+				, Value(MoveTemp(InValue))
+				, bSent(false)
+			{}
+
+			~FSendAwaiter()
+			{
+				if (IsLinked())
+					Channel.Unlink(*this, Channel.SendWaiters, Channel.NumWaitingSenders);
+			}
+
+			bool await_ready()
+			{
+				// Parked senders go first, ParkSender queues us behind them
+				if (Channel.NumWaitingSenders.load() == 0)
+					bSent = Channel.TrySend(MoveTemp(Value));
+				return bSent || Channel.IsClosed();
+			}
+
+			bool await_suspend(std::coroutine_handle<> Handle)
+			{
+				return Channel.ParkSender(*this, Handle);
+			}
+
+			/** Returns false if channel was closed and value was not delivered */
+			bool await_resume()
+			{
+				return bSent;
+			}
+
+		private:
+			friend TAsyncChannel;
+			TAsyncChannel& Channel;
+			T Value;
+			bool bSent;
+		};
+
+		struct FReceiveAwaiter : Private::FAsyncWaiter
+		{
+			explicit FReceiveAwaiter(TAsyncChannel& InChannel)
+				: Channel(InChannel)
+			{}
+
+			/** Value that was already handed to a destroyed receiver is dropped */
+			~FReceiveAwaiter()
+			{
+				if (IsLinked())
+					Channel.Unlink(*this, Channel.ReceiveWaiters, Channel.NumWaitingReceivers);
+			}
+
+			bool await_ready()
+			{
+				return Channel.TryReceiveTo(Value) || Channel.IsClosed();
+			}
+
+			bool await_suspend(std::coroutine_handle<> Handle)
+			{
+				return Channel.ParkReceiver(*this, Handle);
+			}
+
+			/** Returns unset value only if channel is closed and drained */
+			TOptional<T> await_resume()
+			{
+				return MoveTemp(Value);
+			}
+
+		private:
+			friend TAsyncChannel;
+			TAsyncChannel& Channel;
+			TOptional<T> Value;
+		};
+
+		FSendAwaiter Send(T Value)
+		{
+			return FSendAwaiter(*this, MoveTemp(Value));
+		}
+
+		FReceiveAwaiter Receive()
+		{
+			return FReceiveAwaiter(*this);
+		}
+
+		/** Non-suspending send, fails when channel is full or closed */
+		bool TrySend(T&& Value)
+		{
+			if (IsClosed() || !TryPush(Value))
+				return false;
+			WakeIfWaiting(NumWaitingReceivers);
+			return true;
+		}
+
+		bool TrySend(const T& Value)
+		{
+			return TrySend(CopyTemp(Value));
+		}
+
+		TOptional<T> TryReceive()
+		{
+			TOptional<T> Value;
+			TryReceiveTo(Value);
+			return Value;
+		}
+
+		/** Wakes all waiters. Senders get false, receivers drain rest of values and then get unset value */
+		void Close()
+		{
+			Private::FAsyncWaiterQueue ToResume;
+			{
+				FScopeLock Lock(&CriticalSection);
+				bClosed.store(true);
+				Pump(ToResume);
+				while (Private::FAsyncWaiter* Waiter = SendWaiters.Pop())
+					ToResume.Push(Waiter);
+				while (Private::FAsyncWaiter* Waiter = ReceiveWaiters.Pop())
+					ToResume.Push(Waiter);
+				NumWaitingSenders.store(0);
+				NumWaitingReceivers.store(0);
+			}
+			Private::ResumeWaiters(ToResume, CriticalSection);
+		}
+
+		bool IsClosed() const
+		{
+			return bClosed.load(std::memory_order_acquire);
+		}
+
+		uint32 GetCapacity() const
+		{
+			return Capacity;
+		}
+
+		/** Count of buffered values, may be stale while other threads send or receive. Sole producer can rely on the free space it sees */
+		uint32 Num() const
+		{
+			const uint64 Dequeued = DequeuePos.load(std::memory_order_acquire);
+			return (uint32)(EnqueuePos.load(std::memory_order_acquire) - Dequeued);
+		}
+
+	private:
+		struct FCell
+		{
+			std::atomic<uint64> Sequence;
+			TTypeCompatibleBytes<T> Storage;
+		};
+
+		bool TryReceiveTo(TOptional<T>& OutValue)
+		{
+			if (!TryPop(OutValue))
+				return false;
+			WakeIfWaiting(NumWaitingSenders);
+			return true;
+		}
+
+		/**
+		 * Bounded MPMC ring (D. Vyukov): each cell sequence tells whether it is free for the current lap.
+		 * Single cell can't tell a written lap from a free one, so capacity 1 uses two cells and checks fullness by positions
+		 */
+		bool TryPush(T& Value)
+		{
+			uint64 Pos = EnqueuePos.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				FCell& Cell = Cells[Pos % NumCells];
+				const uint64 Sequence = Cell.Sequence.load(std::memory_order_acquire);
+				const int64 Diff = (int64)Sequence - (int64)Pos;
+				if (Diff == 0)
+				{
+					if (NumCells > Capacity && Pos - DequeuePos.load() >= Capacity)
+						return false;
+					if (EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+					{
+						new (Cell.Storage.GetTypedPtr()) T(MoveTemp(Value));
+						Cell.Sequence.store(Pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (Diff < 0)
+				{
+					return false;
+				}
+				else
+				{
+					Pos = EnqueuePos.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		bool TryPop(TOptional<T>& OutValue)
+		{
+			uint64 Pos = DequeuePos.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				FCell& Cell = Cells[Pos % NumCells];
+				const uint64 Sequence = Cell.Sequence.load(std::memory_order_acquire);
+				const int64 Diff = (int64)Sequence - (int64)(Pos + 1);
+				if (Diff == 0)
+				{
+					if (DequeuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+					{
+						T* Stored = Cell.Storage.GetTypedPtr();
+						OutValue.Emplace(MoveTemp(*Stored));
+						DestructItem(Stored);
+						Cell.Sequence.store(Pos + NumCells, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (Diff < 0)
+				{
+					return false;
+				}
+				else
+				{
+					Pos = DequeuePos.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		/**
+		 * Waiting counter is published before the last try under the lock, and checked after every push/pop,
+		 * so either parking side sees the new value or the other side sees the waiter.
+		 * Sender doesn't try if others are parked: the receiver that frees a slot pumps them in order, us included
+		 */
+		bool ParkSender(FSendAwaiter& Awaiter, std::coroutine_handle<> Handle)
+		{
+			{
+				FScopeLock Lock(&CriticalSection);
+				NumWaitingSenders.fetch_add(1);
+				if (!IsClosed() && SendWaiters.IsEmpty())
+					Awaiter.bSent = TryPush(Awaiter.Value);
+				if (!Awaiter.bSent && !IsClosed())
+				{
+					Awaiter.Continuation = FContinuation::Capture(Handle, TEXT("TAsyncChannel::Send"));
+					SendWaiters.Push(&Awaiter);
+					return true;
+				}
+				NumWaitingSenders.fetch_sub(1);
+			}
+			if (Awaiter.bSent)
+				WakeIfWaiting(NumWaitingReceivers);
+			return false;
+		}
+
+		bool ParkReceiver(FReceiveAwaiter& Awaiter, std::coroutine_handle<> Handle)
+		{
+			bool bReceived = false;
+			{
+				FScopeLock Lock(&CriticalSection);
+				NumWaitingReceivers.fetch_add(1);
+				bReceived = TryPop(Awaiter.Value);
+				if (!bReceived && !IsClosed())
+				{
+					Awaiter.Continuation = FContinuation::Capture(Handle, TEXT("TAsyncChannel::Receive"));
+					ReceiveWaiters.Push(&Awaiter);
+					return true;
+				}
+				NumWaitingReceivers.fetch_sub(1);
+			}
+			if (bReceived)
+				WakeIfWaiting(NumWaitingSenders);
+			return false;
+		}
+
+		void WakeIfWaiting(const std::atomic<int32>& NumWaiting)
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (NumWaiting.load() == 0)
+				return;
+
+			Private::FAsyncWaiterQueue ToResume;
+			{
+				FScopeLock Lock(&CriticalSection);
+				Pump(ToResume);
+			}
+			Private::ResumeWaiters(ToResume, CriticalSection);
+		}
+
+		/** Parked waiter leaves its queue, one that is being resumed leaves the queue of the resuming caller */
+		void Unlink(Private::FAsyncWaiter& Waiter, Private::FAsyncWaiterQueue& Parked, std::atomic<int32>& NumWaiting)
+		{
+			FScopeLock Lock(&CriticalSection);
+			Private::FAsyncWaiterQueue* Queue = Waiter.Queue.load(std::memory_order_relaxed);
+			if (Queue == nullptr)
+				return;
+			Queue->Remove(&Waiter);
+			if (Queue == &Parked)
+				NumWaiting.fetch_sub(1);
+		}
+
+		/** Moves values between parked coroutines and the ring until nothing can progress. Called under lock */
+		void Pump(Private::FAsyncWaiterQueue& ToResume)
+		{
+			bool bProgress = true;
+			while (bProgress)
+			{
+				bProgress = false;
+				while (!SendWaiters.IsEmpty())
+				{
+					FSendAwaiter* Sender = static_cast<FSendAwaiter*>(SendWaiters.Head);
+					if (!TryPush(Sender->Value))
+						break;
+					Sender->bSent = true;
+					SendWaiters.Pop();
+					NumWaitingSenders.fetch_sub(1);
+					ToResume.Push(Sender);
+					bProgress = true;
+				}
+				while (!ReceiveWaiters.IsEmpty())
+				{
+					FReceiveAwaiter* Receiver = static_cast<FReceiveAwaiter*>(ReceiveWaiters.Head);
+					if (!TryPop(Receiver->Value))
+						break;
+					ReceiveWaiters.Pop();
+					NumWaitingReceivers.fetch_sub(1);
+					ToResume.Push(Receiver);
+					bProgress = true;
+				}
+			}
+		}
+
+		const uint32 Capacity;
+		const uint32 NumCells;
+		TUniquePtr<FCell[]> Cells;
+
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> EnqueuePos;
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> DequeuePos;
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<int32> NumWaitingSenders;
+		std::atomic<int32> NumWaitingReceivers;
+		std::atomic<bool> bClosed;
+
+		FCriticalSection CriticalSection;
+		Private::FAsyncWaiterQueue SendWaiters;
+		Private::FAsyncWaiterQueue ReceiveWaiters;
+	};
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncDelegate.h"
+
+using namespace CoroTasks;
+
+namespace CoroTasks::Private
+{
+	/** Proxies are rooted and never freed, pool size is the peak count of simultaneous dynamic waits (plus waits released within a frame) */
+	static TArray<FDynamicDelegateSlot*> FreeDynamicDelegateSlots;
+
+	/**
+	 * Slots released in ReleasedSlotsFrame. A broadcast copies its invocation list, so one running right now may still call
+	 * a slot it has already released. Dynamic bindings carry no payload to tell such a call apart, the slot is reused only
+	 * in a later frame, when no broadcast can hold it: until then it has no callback and ProcessEvent ignores it
+	 */
+	static TArray<FDynamicDelegateSlot*> ReleasedDynamicDelegateSlots;
+	static uint64 ReleasedSlotsFrame = 0;
+
+	static void RecycleReleasedSlots()
+	{
+		if (ReleasedSlotsFrame == GFrameCounter)
+			return;
+		FreeDynamicDelegateSlots.Append(ReleasedDynamicDelegateSlots);
+		ReleasedDynamicDelegateSlots.Reset();
+		ReleasedSlotsFrame = GFrameCounter;
+	}
+
+	static const FName DelegateProxySlotNames[UCoroDelegateProxy::NumSlots] =
+	{
+		GET_FUNCTION_NAME_CHECKED(UCoroDelegateProxy, Slot0),
+		GET_FUNCTION_NAME_CHECKED(UCoroDelegateProxy, Slot1),
+		GET_FUNCTION_NAME_CHECKED(UCoroDelegateProxy, Slot2),
+		GET_FUNCTION_NAME_CHECKED(UCoroDelegateProxy, Slot3),
+		GET_FUNCTION_NAME_CHECKED(UCoroDelegateProxy, Slot4),
+		GET_FUNCTION_NAME_CHECKED(UCoroDelegateProxy, Slot5),
+		GET_FUNCTION_NAME_CHECKED(UCoroDelegateProxy, Slot6),
+		GET_FUNCTION_NAME_CHECKED(UCoroDelegateProxy, Slot7),
+	};
+}
+
+Private::FDynamicDelegateSlot* Private::FDynamicDelegateSlot::Acquire(void* InOwner, FCallback InCallback, int32 InCookie)
+{
+	check(IsInGameThread());
+	RecycleReleasedSlots();
+	if (FreeDynamicDelegateSlots.IsEmpty())
+	{
+		UCoroDelegateProxy* Proxy = NewObject<UCoroDelegateProxy>(GetTransientPackage());
+		Proxy->AddToRoot();
+		for (int32 Index = UCoroDelegateProxy::NumSlots - 1; Index >= 0; --Index)
+		{
+			Proxy->Slots[Index].Proxy = Proxy;
+			Proxy->Slots[Index].Index = Index;
+			FreeDynamicDelegateSlots.Push(&Proxy->Slots[Index]);
+		}
+	}
+
+	FDynamicDelegateSlot* Slot = FreeDynamicDelegateSlots.Pop(false);
+	Slot->Owner = InOwner;
+	Slot->Callback = InCallback;
+	Slot->Cookie = InCookie;
+	return Slot;
+}
+
+void Private::FDynamicDelegateSlot::Release()
+{
+	check(IsInGameThread());
+	Owner = nullptr;
+	Callback = nullptr;
+	RecycleReleasedSlots();
+	ReleasedDynamicDelegateSlots.Push(this);
+}
+
+FScriptDelegate Private::FDynamicDelegateSlot::MakeScriptDelegate() const
+{
+	FScriptDelegate ScriptDelegate;
+	ScriptDelegate.BindUFunction(Proxy, DelegateProxySlotNames[Index]);
+	return ScriptDelegate;
+}
+
+FName UCoroDelegateProxy::GetSlotFunctionName(int32 Index)
+{
+	check(Index >= 0 && Index < NumSlots);
+	return Private::DelegateProxySlotNames[Index];
+}
+
+void UCoroDelegateProxy::ProcessEvent(UFunction* Function, void* Parms)
+{
+	const FName FunctionName = Function->GetFName();
+	for (int32 Index = 0; Index < NumSlots; ++Index)
+	{
+		if (Private::DelegateProxySlotNames[Index] == FunctionName)
+		{
+			const Private::FDynamicDelegateSlot& Slot = Slots[Index];
+			if (Slot.Callback)
+				Slot.Callback(Slot.Owner, Slot.Cookie, Parms);
+			return;
+		}
+	}
+	Super::ProcessEvent(Function, Parms);
+}
@@ -0,0 +1,316 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <array>
+#include <utility>
+
+#include "CoreMinimal.h"
+#include "CoroScheduler.h"
+#include "UObject/Object.h"
+#include "UObject/SparseDelegate.h"
+#include "AsyncDelegate.generated.h"
+
+class UCoroDelegateProxy;
+
+namespace CoroTasks::Private
+{
+	/**
+	 * One binding slot of a shared proxy object, dynamic delegates can be bound only to UFunctions.
+	 * Slots are pooled (each proxy object has NumSlots of them), so a wait doesn't create any UObject. Game thread only
+	 */
+	struct COROTASKS_API FDynamicDelegateSlot
+	{
+		/** Parms is the broadcast parameter block of the delegate, Cookie is passed through from Acquire */
+		using FCallback = void(*)(void* Owner, int32 Cookie, void* Parms);
+
+		static FDynamicDelegateSlot* Acquire(void* InOwner, FCallback InCallback, int32 InCookie = 0);
+
+		/** Caller should unbind slot from delegate first. Slot isn't handed out again in the same frame */
+		void Release();
+
+		/** Delegate bound to the slot function of the proxy */
+		FScriptDelegate MakeScriptDelegate() const;
+
+		/** DelegateType is FMulticastScriptDelegate or TSparseDynamicDelegate, they share the binding interface */
+		template<typename DelegateType>
+		void Bind(DelegateType& Delegate) const
+		{
+			Delegate.AddUnique(MakeScriptDelegate());
+		}
+
+		template<typename DelegateType>
+		void Unbind(DelegateType& Delegate) const
+		{
+			Delegate.Remove(MakeScriptDelegate());
+		}
+
+		UCoroDelegateProxy* Proxy = nullptr;
+		int32 Index = 0;
+		void* Owner = nullptr;
+		FCallback Callback = nullptr;
+		int32 Cookie = 0;
+	};
+}
+
+/** Shared target of dynamic delegate waits. Slot functions have no parameters, so they can be bound to delegate of any signature */
+UCLASS(Transient)
+class COROTASKS_API UCoroDelegateProxy : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr int32 NumSlots = 8;
+
+	static FName GetSlotFunctionName(int32 Index);
+
+	/** Broadcast is dispatched to the slot owner right here, slot functions themselves are never executed */
+	virtual void ProcessEvent(UFunction* Function, void* Parms) override;
+
+	UFUNCTION()
+	void Slot0() {}
+	UFUNCTION()
+	void Slot1() {}
+	UFUNCTION()
+	void Slot2() {}
+	UFUNCTION()
+	void Slot3() {}
+	UFUNCTION()
+	void Slot4() {}
+	UFUNCTION()
+	void Slot5() {}
+	UFUNCTION()
+	void Slot6() {}
+	UFUNCTION()
+	void Slot7() {}
+
+	CoroTasks::Private::FDynamicDelegateSlot Slots[NumSlots];
+};
+
+/**
+ * Tour to delegate awaitables:
+ * WaitDelegate suspends until the next broadcast of a multicast delegate and returns its parameters as a tuple
+ * (or nothing for delegates without parameters). Binding is made on suspend and removed on fire or when the awaiting frame is destroyed.
+ *	1. Native multicast delegates	- the awaiter in the (pooled) coroutine frame is the binding node
+ *	2. Dynamic multicast delegates	- binding is a pooled slot of shared UCoroDelegateProxy object
+ *	3. Sparse dynamic delegates		- the same slots, bound through AddUnique/Remove of the sparse delegate (most actor and component events)
+ * Delegate should outlive the wait, or pass its owner object: then the binding is not touched once the owner is destroyed
+ *
+ * Use case:
+ *	>>> auto [OverlappedActor, OtherActor] = co_await CoroTasks::WaitDelegate(Trigger->OnActorBeginOverlap, Trigger);
+ *	>>> co_await CoroTasks::WaitDelegate(FWorldDelegates::OnWorldCleanup);
+ */
+namespace CoroTasks
+{
+	namespace Private
+	{
+		template<typename... ParamTypes>
+		using TDelegatePayload = TTuple<std::decay_t<ParamTypes>...>;
+
+		/** Broadcast block of dynamic delegate is a plain struct of decayed parameter types (see generated *_DelegateWrapper) */
+		template<typename... Ts>
+		constexpr std::array<SIZE_T, sizeof...(Ts)> GetDynamicParmsOffsets()
+		{
+			std::array<SIZE_T, sizeof...(Ts)> Offsets{};
+			if constexpr (sizeof...(Ts) > 0)
+			{
+				constexpr SIZE_T Sizes[] = {sizeof(Ts)...};
+				constexpr SIZE_T Alignments[] = {alignof(Ts)...};
+				SIZE_T Offset = 0;
+				for (SIZE_T Index = 0; Index < sizeof...(Ts); ++Index)
+				{
+					Offset = (Offset + Alignments[Index] - 1) / Alignments[Index] * Alignments[Index];
+					Offsets[Index] = Offset;
+					Offset += Sizes[Index];
+				}
+			}
+			return Offsets;
+		}
+
+		template<typename... ParamTypes, SIZE_T... Indices>
+		TDelegatePayload<ParamTypes...> ReadDynamicParms([[maybe_unused]] const void* Parms, std::index_sequence<Indices...>)
+		{
+			[[maybe_unused]] constexpr auto Offsets = GetDynamicParmsOffsets<std::decay_t<ParamTypes>...>();
+			[[maybe_unused]] const uint8* Bytes = static_cast<const uint8*>(Parms);
+			return TDelegatePayload<ParamTypes...>(*reinterpret_cast<const std::decay_t<ParamTypes>*>(Bytes + Offsets[Indices])...);
+		}
+
+		template<typename... ParamTypes>
+		class TWaitDelegateAwaiter_Base
+		{
+		public:
+			explicit TWaitDelegateAwaiter_Base(const UObject* InDelegateOwner)
+				: DelegateOwner(InDelegateOwner)
+				, bTrackOwner(InDelegateOwner != nullptr)
+			{}
+
+			/** Lives in the awaiting frame and is bound by address */
+			TWaitDelegateAwaiter_Base(const TWaitDelegateAwaiter_Base&) = delete;
+			TWaitDelegateAwaiter_Base& operator=(const TWaitDelegateAwaiter_Base&) = delete;
+
+			bool await_ready() const
+			{
+				return false;
+			}
+
+			auto await_resume()
+			{
+				if constexpr (sizeof...(ParamTypes) > 0)
+					return MoveTemp(Payload.GetValue());
+			}
+
+		protected:
+			/** Garbage owner is still reachable, so its delegate can be cleaned */
+			bool CanUnbind() const
+			{
+				return !bTrackOwner || DelegateOwner.Get(true) != nullptr;
+			}
+
+			TWeakObjectPtr<const UObject> DelegateOwner;
+			TOptional<TDelegatePayload<ParamTypes...>> Payload;
+			FContinuation Continuation;
+			bool bTrackOwner;
+		};
+	}
+
+	template<typename UserPolicy, typename... ParamTypes>
+	class TWaitNativeDelegateAwaiter : public Private::TWaitDelegateAwaiter_Base<ParamTypes...>
+	{
+	public:
+		using DelegateType = TMulticastDelegate<void(ParamTypes...), UserPolicy>;
+
+		TWaitNativeDelegateAwaiter(DelegateType& InDelegate, const UObject* InDelegateOwner)
+			: Private::TWaitDelegateAwaiter_Base<ParamTypes...>(InDelegateOwner)
+			, Delegate(InDelegate)
+		{}
+
+		~TWaitNativeDelegateAwaiter()
+		{
+			Unbind();
+		}
+
+		void await_suspend(std::coroutine_handle<> Handle)
+		{
+			this->Continuation = FContinuation::Capture(Handle, TEXT("WaitDelegate"));
+			DelegateHandle = Delegate.AddLambda([this](ParamTypes... Params)
+			{
+				// Removal during broadcast destroys this lambda, so nothing captured is touched after Unbind
+				TWaitNativeDelegateAwaiter* Self = this;
+				Self->Payload.Emplace(Params...);
+				Self->Unbind();
+				Self->Continuation.Resume();
+			});
+		}
+
+	private:
+		void Unbind()
+		{
+			if (DelegateHandle.IsValid() && this->CanUnbind())
+				Delegate.Remove(DelegateHandle);
+			DelegateHandle.Reset();
+		}
+
+		DelegateType& Delegate;
+		FDelegateHandle DelegateHandle;
+	};
+
+	/** DelegateType is FMulticastScriptDelegate or TSparseDynamicDelegate */
+	template<typename DelegateType, typename... ParamTypes>
+	class TWaitDynamicDelegateAwaiter : public Private::TWaitDelegateAwaiter_Base<ParamTypes...>
+	{
+	public:
+		TWaitDynamicDelegateAwaiter(DelegateType& InDelegate, const UObject* InDelegateOwner)
+			: Private::TWaitDelegateAwaiter_Base<ParamTypes...>(InDelegateOwner)
+			, Delegate(InDelegate)
+			, Slot(nullptr)
+		{}
+
+		~TWaitDynamicDelegateAwaiter()
+		{
+			Unbind();
+		}
+
+		void await_suspend(std::coroutine_handle<> Handle)
+		{
+			this->Continuation = FContinuation::Capture(Handle, TEXT("WaitDelegate"));
+			Slot = Private::FDynamicDelegateSlot::Acquire(this, &TWaitDynamicDelegateAwaiter::OnFired);
+			Slot->Bind(Delegate);
+		}
+
+	private:
+		static void OnFired(void* Owner, int32 Cookie, void* Parms)
+		{
+			TWaitDynamicDelegateAwaiter* Self = static_cast<TWaitDynamicDelegateAwaiter*>(Owner);
+			Self->Payload.Emplace(Private::ReadDynamicParms<ParamTypes...>(Parms, std::index_sequence_for<ParamTypes...>()));
+			// Invocation list is copied by broadcast, so removal is safe
+			Self->Unbind();
+			Self->Continuation.Resume();
+		}
+
+		void Unbind()
+		{
+			if (!Slot)
+				return;
+			if (this->CanUnbind())
+				Slot->Unbind(Delegate);
+			Slot->Release();
+			Slot = nullptr;
+		}
+
+		DelegateType& Delegate;
+		Private::FDynamicDelegateSlot* Slot;
+	};
+
+	namespace Private
+	{
+		/** Parameters of sparse delegate come from its multicast signature type */
+		template<typename SparseDelegateType, typename DelegateMode, typename... ParamTypes>
+		TWaitDynamicDelegateAwaiter<SparseDelegateType, ParamTypes...> MakeSparseDelegateAwaiter(SparseDelegateType& Delegate,
+			const TBaseDynamicMulticastDelegate<DelegateMode, void, ParamTypes...>*, const UObject* DelegateOwner)
+		{
+			return TWaitDynamicDelegateAwaiter<SparseDelegateType, ParamTypes...>(Delegate, DelegateOwner);
+		}
+	}
+
+	/** Resumes on the next broadcast of native multicast delegate, returns TTuple of its parameters */
+	template<typename UserPolicy, typename... ParamTypes>
+	TWaitNativeDelegateAwaiter<UserPolicy, ParamTypes...> WaitDelegate(TMulticastDelegate<void(ParamTypes...), UserPolicy>& Delegate, const UObject* DelegateOwner = nullptr)
+	{
+		return TWaitNativeDelegateAwaiter<UserPolicy, ParamTypes...>(Delegate, DelegateOwner);
+	}
+
+	/** Resumes on the next broadcast of dynamic multicast delegate, returns TTuple of its parameters */
+	template<typename DelegateMode, typename... ParamTypes>
+	TWaitDynamicDelegateAwaiter<FMulticastScriptDelegate, ParamTypes...> WaitDelegate(TBaseDynamicMulticastDelegate<DelegateMode, void, ParamTypes...>& Delegate, const UObject* DelegateOwner = nullptr)
+	{
+		return TWaitDynamicDelegateAwaiter<FMulticastScriptDelegate, ParamTypes...>(Delegate, DelegateOwner);
+	}
+
+	/** Resumes on the next broadcast of sparse dynamic delegate (e.g. AActor::OnActorBeginOverlap), returns TTuple of its parameters */
+	template<typename MulticastDelegate, typename OwningClass, typename DelegateInfoClass>
+	auto WaitDelegate(TSparseDynamicDelegate<MulticastDelegate, OwningClass, DelegateInfoClass>& Delegate, const UObject* DelegateOwner = nullptr)
+	{
+		return Private::MakeSparseDelegateAwaiter(Delegate, static_cast<const MulticastDelegate*>(nullptr), DelegateOwner);
+	}
+}
@@ -0,0 +1,149 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncNavigation.h"
+#include "NavMesh/NavMeshPath.h"
+
+using namespace CoroTasks;
+
+namespace CoroTasks::Private
+{
+	struct FAsyncPathRequest
+	{
+		TWeakObjectPtr<UNavigationSystemV1> NavSys;
+		uint32 QueryID = INVALID_NAVQUERYID;
+		uint64 Frame = 0;
+		TArray<FFindPathAwaiter*, TInlineAllocator<1>> Awaiters;
+	};
+
+	static TMap<uint32, TUniquePtr<FAsyncPathRequest>> AsyncPathRequests;
+
+	/** Requests issued in the current frame, only they can be joined */
+	static TArray<FAsyncPathRequest*> FreshAsyncPathRequests;
+	static uint64 FreshAsyncPathFrame = 0;
+
+	static const FNavPathQueryDelegate AsyncPathDelegate = FNavPathQueryDelegate::CreateStatic(&FAsyncPathDispatcher::OnPathFound);
+
+	static FNavPathSharedPtr CopyPath(const FNavPathSharedPtr& Path)
+	{
+		if (!Path.IsValid())
+			return Path;
+		if (const FNavMeshPath* NavMeshPath = Path->CastPath<FNavMeshPath>())
+			return MakeShared<FNavMeshPath, ESPMode::ThreadSafe>(*NavMeshPath);
+		return MakeShared<FNavigationPath, ESPMode::ThreadSafe>(*Path);
+	}
+}
+
+void Private::FAsyncPathDispatcher::Issue(FFindPathAwaiter& Awaiter)
+{
+	check(IsInGameThread());
+	if (FreshAsyncPathFrame != GFrameCounter)
+	{
+		FreshAsyncPathFrame = GFrameCounter;
+		FreshAsyncPathRequests.Reset();
+	}
+
+	for (FAsyncPathRequest* Request : FreshAsyncPathRequests)
+	{
+		const FFindPathAwaiter& First = *Request->Awaiters[0];
+		if (Request->NavSys.Get() == Awaiter.NavSys && First.Mode == Awaiter.Mode
+			&& First.Query.NavData == Awaiter.Query.NavData
+			&& First.Query.QueryFilter == Awaiter.Query.QueryFilter
+			&& First.Query.bAllowPartialPaths == Awaiter.Query.bAllowPartialPaths
+			&& First.Query.CostLimit == Awaiter.Query.CostLimit
+			&& First.Query.StartLocation.Equals(Awaiter.Query.StartLocation)
+			&& First.Query.EndLocation.Equals(Awaiter.Query.EndLocation))
+		{
+			Request->Awaiters.Add(&Awaiter);
+			Awaiter.QueryID = Request->QueryID;
+			return;
+		}
+	}
+
+	const uint32 QueryID = Awaiter.NavSys->FindPathAsync(Awaiter.Query.NavAgentProperties, Awaiter.Query, AsyncPathDelegate, Awaiter.Mode);
+	if (QueryID == INVALID_NAVQUERYID)
+	{
+		Awaiter.Result.Result = ENavigationQueryResult::Error;
+		return;
+	}
+
+	TUniquePtr<FAsyncPathRequest>& Request = AsyncPathRequests.Add(QueryID, MakeUnique<FAsyncPathRequest>());
+	Request->NavSys = Awaiter.NavSys;
+	Request->QueryID = QueryID;
+	Request->Awaiters.Add(&Awaiter);
+	FreshAsyncPathRequests.Add(Request.Get());
+	Awaiter.QueryID = QueryID;
+}
+
+void Private::FAsyncPathDispatcher::Leave(FFindPathAwaiter& Awaiter)
+{
+	check(IsInGameThread());
+	const TUniquePtr<FAsyncPathRequest>* Request = AsyncPathRequests.Find(Awaiter.QueryID);
+	Awaiter.QueryID = INVALID_NAVQUERYID;
+	if (!Request)
+		return;
+
+	(*Request)->Awaiters.RemoveSingleSwap(&Awaiter);
+	if ((*Request)->Awaiters.IsEmpty())
+	{
+		if (UNavigationSystemV1* NavSys = (*Request)->NavSys.Get())
+			NavSys->AbortAsyncFindPathRequest((*Request)->QueryID);
+		FreshAsyncPathRequests.RemoveSingleSwap(Request->Get());
+		AsyncPathRequests.Remove((*Request)->QueryID);
+	}
+}
+
+void Private::FAsyncPathDispatcher::OnPathFound(uint32 QueryID, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+	TUniquePtr<FAsyncPathRequest> Request;
+	if (!AsyncPathRequests.RemoveAndCopyValue(QueryID, Request))
+		return;
+	FreshAsyncPathRequests.RemoveSingleSwap(Request.Get());
+
+	// Detached first: resumed coroutines may issue new queries. RequestMove modifies the path, so each awaiter gets its own
+	TArray<FFindPathAwaiter*, TInlineAllocator<1>> Resuming = MoveTemp(Request->Awaiters);
+	for (int32 Index = 0; Index < Resuming.Num(); ++Index)
+	{
+		FFindPathAwaiter* Awaiter = Resuming[Index];
+		Awaiter->QueryID = INVALID_NAVQUERYID;
+		Awaiter->ResumeSlot = &Resuming[Index];
+		Awaiter->Result = FPathFindingResult(Result);
+		Awaiter->Result.Path = Index == 0 ? Path : CopyPath(Path);
+	}
+
+	// Resumed coroutine may destroy a sibling awaiter, which nulls its entry
+	for (FFindPathAwaiter*& Entry : Resuming)
+	{
+		if (FFindPathAwaiter* Awaiter = Entry)
+		{
+			Awaiter->ResumeSlot = nullptr;
+			const FContinuation Continuation = Awaiter->Continuation;
+			Continuation.Resume();
+		}
+	}
+}
+
+int32 Private::FAsyncPathDispatcher::GetNumPendingQueries()
+{
+	return AsyncPathRequests.Num();
+}
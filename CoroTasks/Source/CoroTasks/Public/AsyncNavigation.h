@@ -0,0 +1,126 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CoroScheduler.h"
+#include "NavigationSystem.h"
+#include "NavigationSystemTypes.h"
+
+/**
+ * Tour to async pathfinding:
+ * FindPathAsync runs the query through UNavigationSystemV1 async queries and resumes with FPathFindingResult.
+ * Identical queries issued in the same frame (same nav data, start, goal, filter and mode) are coalesced into one engine query,
+ * each awaiter gets its own copy of the found path (RequestMove modifies it). When the awaiting frame is destroyed (cancelled),
+ * the awaiter leaves its query, and the engine query is aborted once nobody waits for it
+ *
+ * Use case:
+ *	>>> FPathFindingQuery Query(Controller, *NavData, Pawn->GetNavAgentLocation(), GoalLocation);
+ *	>>> FPathFindingResult Result = co_await CoroTasks::FindPathAsync(NavSys, Query);
+ *	>>> if (Result.IsSuccessful())
+ *	>>>		Controller->GetPathFollowingComponent()->RequestMove(FAIMoveRequest(GoalLocation), Result.Path);
+ */
+namespace CoroTasks
+{
+	class FFindPathAwaiter;
+
+	namespace Private
+	{
+		/** Game thread only, like async queries of navigation system */
+		class COROTASKS_API FAsyncPathDispatcher
+		{
+		public:
+			static void Issue(FFindPathAwaiter& Awaiter);
+			static void Leave(FFindPathAwaiter& Awaiter);
+
+			/** Engine queries in flight, coalesced awaiters share one */
+			static int32 GetNumPendingQueries();
+
+		private:
+			static void OnPathFound(uint32 QueryID, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+		};
+	}
+
+	class COROTASKS_API FFindPathAwaiter
+	{
+	public:
+		FFindPathAwaiter(UNavigationSystemV1* InNavSys, const FPathFindingQuery& InQuery, EPathFindingMode::Type InMode)
+			: NavSys(InNavSys)
+			, Query(InQuery)
+			, Mode(InMode)
+			, QueryID(INVALID_NAVQUERYID)
+			, ResumeSlot(nullptr)
+		{}
+
+		/** Lives in the awaiting frame and is found by address */
+		FFindPathAwaiter(const FFindPathAwaiter&) = delete;
+		FFindPathAwaiter& operator=(const FFindPathAwaiter&) = delete;
+
+		~FFindPathAwaiter()
+		{
+			if (QueryID != INVALID_NAVQUERYID)
+				Private::FAsyncPathDispatcher::Leave(*this);
+			if (ResumeSlot)
+				*ResumeSlot = nullptr;
+		}
+
+		bool await_ready()
+		{
+			if (NavSys == nullptr)
+				Result.Result = ENavigationQueryResult::Error;
+			return NavSys == nullptr;
+		}
+
+		/** Resumes immediately with error if navigation system rejects the query */
+		bool await_suspend(std::coroutine_handle<> Handle)
+		{
+			Continuation = FContinuation::Capture(Handle, TEXT("FindPathAsync"));
+			Private::FAsyncPathDispatcher::Issue(*this);
+			return QueryID != INVALID_NAVQUERYID;
+		}
+
+		FPathFindingResult await_resume()
+		{
+			return MoveTemp(Result);
+		}
+
+	private:
+		friend Private::FAsyncPathDispatcher;
+
+		UNavigationSystemV1* NavSys;
+		FPathFindingQuery Query;
+		EPathFindingMode::Type Mode;
+		uint32 QueryID;
+		/** Entry of the awaiters being resumed, nulled if a resumed sibling destroys this one first */
+		FFindPathAwaiter** ResumeSlot;
+		FPathFindingResult Result;
+		FContinuation Continuation;
+	};
+
+	/** Query.NavAgentProperties are used as agent properties */
+	inline FFindPathAwaiter FindPathAsync(UNavigationSystemV1* NavSys, const FPathFindingQuery& Query, EPathFindingMode::Type Mode = EPathFindingMode::Regular)
+	{
+		return FFindPathAwaiter(NavSys, Query, Mode);
+	}
+}
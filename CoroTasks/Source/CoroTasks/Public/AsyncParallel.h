@@ -0,0 +1,264 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "CoroScheduler.h"
+#include "HAL/PlatformProcess.h"
+#include "Tasks/Task.h"
+
+#include <atomic>
+
+/**
+ * Tour to parallel loops:
+ * CPU heavy steps of a coroutine are split across worker threads without blocking the awaiting thread,
+ * coroutine continues on its original thread (the game thread stays the game thread) when all items are processed
+ *	1. ParallelFor(Num, Body, MinBatchSize)							- calls Body(Index) for each index
+ *	2. ParallelReduce(Num, Identity, Map, Reduce, MinBatchSize)	- Reduce(Acc, Map(Index)) per worker, then partial
+ *																	  results are reduced together
+ * Range is split into one slice per worker, a worker takes batches from its slice and then steals batches
+ * from slices of other workers, so uneven item costs are balanced.
+ * Reduce should be associative and commutative: the order items are combined in depends on stealing.
+ * Body must not throw and must not touch game thread only state
+ *
+ * Use case:
+ * >>> TArray<UStaticMesh*> Meshes = co_await CoroTasks::LoadMultipleObjects(MeshAssets);
+ * >>> TArray<FBox> Bounds;
+ * >>> Bounds.SetNum(Meshes.Num());
+ * >>> co_await CoroTasks::ParallelFor(Meshes.Num(), [&] (int32 Index) { Bounds[Index] = BuildBounds(Meshes[Index]); });
+ *
+ * >>> const float BestScore = co_await CoroTasks::ParallelReduce(Candidates.Num(), -MAX_flt,
+ * >>>		[&] (int32 Index) { return Score(Candidates[Index]); },
+ * >>>		[] (float A, float B) { return FMath::Max(A, B); });
+ */
+namespace CoroTasks
+{
+	namespace Private
+	{
+		/**
+		 * Shared part of parallel awaiters. It lives in the awaiting frame, workers reference it until the last one resumes
+		 * the coroutine. BatchBody(WorkerIndex, NextBatch) runs a worker, NextBatch(Begin, End) returns false when no batches are left.
+		 * Awaiter destroyed (cancelled) while workers run stops handing out batches and waits for the ones in flight
+		 */
+		template<typename BatchBodyType>
+		class TParallelAwaiter_Base
+		{
+		public:
+			TParallelAwaiter_Base(int32 InNum, int32 InMinBatchSize, BatchBodyType&& InBatchBody)
+				: BatchBody(MoveTemp(InBatchBody))
+				, Num(FMath::Max(InNum, 0))
+				, BatchSize(FMath::Max(InMinBatchSize, 1))
+				, NumWorkers(Num > 0 ? FMath::Clamp(FMath::DivideAndRoundUp(Num, BatchSize), 1, FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1)) : 0)
+				, NumActiveWorkers(NumWorkers)
+			{}
+
+			TParallelAwaiter_Base(const TParallelAwaiter_Base&) = delete;
+			TParallelAwaiter_Base& operator=(const TParallelAwaiter_Base&) = delete;
+
+			~TParallelAwaiter_Base()
+			{
+				if (!Continuation)
+					return;
+
+				// Extra worker keeps the last real one from resuming, the rest finish their current batch
+				bStopped.store(true, std::memory_order_relaxed);
+				if (NumActiveWorkers.fetch_add(1, std::memory_order_acq_rel) > 0)
+				{
+					while (NumActiveWorkers.load(std::memory_order_acquire) > 1)
+						FPlatformProcess::Yield();
+				}
+				Continuation->Revoke();
+			}
+
+			int32 GetNumWorkers() const
+			{
+				return NumWorkers;
+			}
+
+			bool await_ready() const
+			{
+				return Num == 0;
+			}
+
+			void await_suspend(std::coroutine_handle<> Handle)
+			{
+				const TSharedRef<FRevocableContinuation, ESPMode::ThreadSafe> Shared =
+					MakeShared<FRevocableContinuation, ESPMode::ThreadSafe>(FContinuation::Capture(Handle, TEXT("ParallelFor")));
+				Continuation = Shared;
+
+				Slices = MakeUnique<FSlice[]>(NumWorkers);
+				for (int32 WorkerIndex = 0; WorkerIndex < NumWorkers; ++WorkerIndex)
+				{
+					Slices[WorkerIndex].Next.store((int32)((int64)Num * WorkerIndex / NumWorkers), std::memory_order_relaxed);
+					Slices[WorkerIndex].End = (int32)((int64)Num * (WorkerIndex + 1) / NumWorkers);
+				}
+
+				// Last worker may resume and destroy the awaiter before the loop ends
+				const int32 NumToLaunch = NumWorkers;
+				for (int32 WorkerIndex = 0; WorkerIndex < NumToLaunch; ++WorkerIndex)
+				{
+					UE::Tasks::Launch(TEXT("CoroTasks::ParallelFor"), [this, WorkerIndex, Shared] { RunWorker(WorkerIndex, Shared); });
+				}
+			}
+
+		protected:
+			struct alignas(PLATFORM_CACHE_LINE_SIZE) FSlice
+			{
+				std::atomic<int32> Next = 0;
+				int32 End = 0;
+			};
+
+			void RunWorker(int32 WorkerIndex, const TSharedRef<FRevocableContinuation, ESPMode::ThreadSafe>& Shared)
+			{
+				int32 Offset = 0;
+				BatchBody(WorkerIndex, [this, WorkerIndex, &Offset] (int32& OutBegin, int32& OutEnd)
+				{
+					if (bStopped.load(std::memory_order_relaxed))
+						return false;
+					for (; Offset < NumWorkers; ++Offset)
+					{
+						FSlice& Slice = Slices[(WorkerIndex + Offset) % NumWorkers];
+						const int32 Begin = Slice.Next.fetch_add(BatchSize, std::memory_order_relaxed);
+						if (Begin < Slice.End)
+						{
+							OutBegin = Begin;
+							OutEnd = FMath::Min(Begin + BatchSize, Slice.End);
+							return true;
+						}
+					}
+					return false;
+				});
+
+				// Results of all workers are visible to the last one, it resumes the coroutine.
+				// The awaiter may be gone right after the decrement, so only the shared continuation is used
+				if (NumActiveWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					Shared->Resume();
+			}
+
+			BatchBodyType BatchBody;
+			const int32 Num;
+			const int32 BatchSize;
+			const int32 NumWorkers;
+			std::atomic<int32> NumActiveWorkers;
+			std::atomic<bool> bStopped = false;
+			TUniquePtr<FSlice[]> Slices;
+			TSharedPtr<FRevocableContinuation, ESPMode::ThreadSafe> Continuation;
+		};
+
+		template<typename BodyType>
+		struct TParallelForBatch
+		{
+			BodyType Body;
+
+			template<typename NextBatchType>
+			void operator()(int32 WorkerIndex, NextBatchType&& NextBatch)
+			{
+				int32 Begin, End;
+				while (NextBatch(Begin, End))
+				{
+					for (int32 Index = Begin; Index < End; ++Index)
+						Body(Index);
+				}
+			}
+		};
+
+		template<typename BodyType>
+		class TParallelForAwaiter : public TParallelAwaiter_Base<TParallelForBatch<BodyType>>
+		{
+		public:
+			using Super = TParallelAwaiter_Base<TParallelForBatch<BodyType>>;
+
+			TParallelForAwaiter(int32 InNum, BodyType&& Body, int32 InMinBatchSize)
+				: Super(InNum, InMinBatchSize, TParallelForBatch<BodyType>{MoveTemp(Body)})
+			{}
+
+			void await_resume()
+			{
+			}
+		};
+
+		template<typename T, typename MapType, typename ReduceType>
+		struct TParallelReduceBatch
+		{
+			MapType Map;
+			ReduceType Reduce;
+			TArray<T> Partials;
+
+			template<typename NextBatchType>
+			void operator()(int32 WorkerIndex, NextBatchType&& NextBatch)
+			{
+				// Partials of neighbour workers may share a cache line, they are written once
+				T Accumulator = MoveTemp(Partials[WorkerIndex]);
+				int32 Begin, End;
+				while (NextBatch(Begin, End))
+				{
+					for (int32 Index = Begin; Index < End; ++Index)
+						Accumulator = Reduce(MoveTemp(Accumulator), Map(Index));
+				}
+				Partials[WorkerIndex] = MoveTemp(Accumulator);
+			}
+		};
+
+		template<typename T, typename MapType, typename ReduceType>
+		class TParallelReduceAwaiter : public TParallelAwaiter_Base<TParallelReduceBatch<T, MapType, ReduceType>>
+		{
+		public:
+			using Super = TParallelAwaiter_Base<TParallelReduceBatch<T, MapType, ReduceType>>;
+
+			TParallelReduceAwaiter(int32 InNum, const T& InIdentity, MapType&& Map, ReduceType&& Reduce, int32 InMinBatchSize)
+				: Super(InNum, InMinBatchSize, TParallelReduceBatch<T, MapType, ReduceType>{MoveTemp(Map), MoveTemp(Reduce), {}})
+				, Identity(InIdentity)
+			{
+				Super::BatchBody.Partials.Init(Identity, FMath::Max(Super::GetNumWorkers(), 1));
+			}
+
+			T await_resume()
+			{
+				T Result = Identity;
+				for (T& Partial : Super::BatchBody.Partials)
+					Result = Super::BatchBody.Reduce(MoveTemp(Result), MoveTemp(Partial));
+				return Result;
+			}
+
+		private:
+			T Identity;
+		};
+	}
+
+	/** Calls Body(int32 Index) for Index in [0, Num) on worker threads, at least MinBatchSize items per batch */
+	template<typename BodyType>
+	Private::TParallelForAwaiter<std::decay_t<BodyType>> ParallelFor(int32 Num, BodyType&& Body, int32 MinBatchSize = 1)
+	{
+		return Private::TParallelForAwaiter<std::decay_t<BodyType>>(Num, std::decay_t<BodyType>(Forward<BodyType>(Body)), MinBatchSize);
+	}
+
+	/** Returns Reduce of Map(Index) for Index in [0, Num) starting from Identity, computed on worker threads */
+	template<typename T, typename MapType, typename ReduceType>
+	Private::TParallelReduceAwaiter<T, std::decay_t<MapType>, std::decay_t<ReduceType>> ParallelReduce(int32 Num, const T& Identity, MapType&& Map, ReduceType&& Reduce, int32 MinBatchSize = 1)
+	{
+		return Private::TParallelReduceAwaiter<T, std::decay_t<MapType>, std::decay_t<ReduceType>>(
+			Num, Identity, std::decay_t<MapType>(Forward<MapType>(Map)), std::decay_t<ReduceType>(Forward<ReduceType>(Reduce)), MinBatchSize);
+	}
+}
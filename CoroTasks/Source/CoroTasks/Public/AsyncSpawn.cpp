@@ -0,0 +1,180 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncSpawn.h"
+#include "CoroTasks.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "HAL/IConsoleManager.h"
+
+using namespace CoroTasks;
+
+namespace
+{
+	TAutoConsoleVariable<float> CVarSpawnBudgetMs(
+		TEXT("CoroTasks.SpawnBudgetMs"),
+		2.f,
+		TEXT("Time per frame spent by SpawnActorAsync queue of a world, at least one actor is spawned per frame"));
+}
+
+FSpawnActorAwaiter::FSpawnActorAwaiter(UWorld* World, const TSoftClassPtr<AActor>& InClass, const FTransform& InTransform, const FActorSpawnParameters& InParams,
+	float InPriority, TFunction<void(AActor*)>&& InInitialize)
+	: Class(InClass)
+	, Transform(InTransform)
+	, Params(InParams)
+	, Owner(InParams.Owner)
+	, Instigator(InParams.Instigator)
+	, OverrideLevel(InParams.OverrideLevel)
+	, Template(InParams.Template)
+	, Initialize(MoveTemp(InInitialize))
+	, Actor(nullptr)
+	, Priority(InPriority)
+	, Sequence(0)
+	, bQueued(false)
+{
+	check(IsInGameThread());
+	UCoroSpawnSubsystem* SubsystemPtr = World ? World->GetSubsystem<UCoroSpawnSubsystem>() : nullptr;
+	if (ensureMsgf(SubsystemPtr, TEXT("Spawning in a world without UCoroSpawnSubsystem, nothing is spawned")))
+		Subsystem = SubsystemPtr;
+}
+
+FSpawnActorAwaiter::~FSpawnActorAwaiter()
+{
+	if (LoadHandle && LoadHandle->IsLoadingInProgress())
+		LoadHandle->CancelHandle();
+
+	if (bQueued)
+	{
+		if (UCoroSpawnSubsystem* SubsystemPtr = Subsystem.Get(true))
+			SubsystemPtr->Dequeue(this);
+	}
+}
+
+void FSpawnActorAwaiter::await_suspend(std::coroutine_handle<> Handle)
+{
+	Continuation = FContinuation::Capture(Handle, TEXT("SpawnActorAsync"));
+	if (Class.IsNull() || Class.Get())
+	{
+		Subsystem->Enqueue(this);
+		return;
+	}
+
+	// Delegate may be called right here if class is loaded meanwhile. Handle keeps the class loaded until it's spawned
+	LoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Class.ToSoftObjectPath(),
+		FStreamableDelegate::CreateRaw(this, &FSpawnActorAwaiter::OnClassLoaded), FStreamableManager::DefaultAsyncLoadPriority);
+	if (!LoadHandle)
+		Subsystem->Enqueue(this);
+}
+
+void FSpawnActorAwaiter::OnClassLoaded()
+{
+	UCoroSpawnSubsystem* SubsystemPtr = Subsystem.Get();
+	if (SubsystemPtr && !SubsystemPtr->bDeinitialized)
+		SubsystemPtr->Enqueue(this);
+}
+
+bool FSpawnActorAwaiter::AreParamsAlive() const
+{
+	return (!Params.Owner || Owner.IsValid())
+		&& (!Params.Instigator || Instigator.IsValid())
+		&& (!Params.OverrideLevel || OverrideLevel.IsValid())
+		&& (!Params.Template || Template.IsValid());
+}
+
+
+void UCoroSpawnSubsystem::Deinitialize()
+{
+	bDeinitialized = true;
+	for (FSpawnActorAwaiter* Awaiter : Queue)
+		Awaiter->bQueued = false;
+	Queue.Reset();
+	Super::Deinitialize();
+}
+
+void UCoroSpawnSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Resumed coroutines may queue new spawns or cancel queued ones, so the heap is popped one at a time
+	const double Deadline = FPlatformTime::Seconds() + CVarSpawnBudgetMs.GetValueOnGameThread() / 1000.0;
+	for (bool bFirst = true; !Queue.IsEmpty() && (bFirst || FPlatformTime::Seconds() < Deadline); bFirst = false)
+	{
+		FSpawnActorAwaiter* Awaiter = nullptr;
+		Queue.HeapPop(Awaiter, FSpawnActorAwaiter::FOrder(), false);
+		Awaiter->bQueued = false;
+		Awaiter->Actor = Spawn(*Awaiter);
+		// Spawned actor references its class now
+		Awaiter->LoadHandle.Reset();
+		Awaiter->Continuation.Resume();
+	}
+}
+
+bool UCoroSpawnSubsystem::IsTickable() const
+{
+	return !Queue.IsEmpty();
+}
+
+TStatId UCoroSpawnSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCoroSpawnSubsystem, STATGROUP_Tickables);
+}
+
+void UCoroSpawnSubsystem::Enqueue(FSpawnActorAwaiter* Awaiter)
+{
+	Awaiter->Sequence = Sequence++;
+	Awaiter->bQueued = true;
+	Queue.HeapPush(Awaiter, FSpawnActorAwaiter::FOrder());
+}
+
+void UCoroSpawnSubsystem::Dequeue(FSpawnActorAwaiter* Awaiter)
+{
+	Queue.RemoveSingle(Awaiter);
+	Queue.Heapify(FSpawnActorAwaiter::FOrder());
+	Awaiter->bQueued = false;
+}
+
+AActor* UCoroSpawnSubsystem::Spawn(FSpawnActorAwaiter& Awaiter)
+{
+	UClass* Class = Awaiter.Class.Get();
+	if (!Class)
+	{
+		UE_LOG(LogCoroTasks, Warning, TEXT("SpawnActorAsync: class %s is not loaded"), *Awaiter.Class.ToString());
+		return nullptr;
+	}
+	if (!Awaiter.AreParamsAlive())
+	{
+		UE_LOG(LogCoroTasks, Warning, TEXT("SpawnActorAsync: spawn parameters of %s reference destroyed objects"), *Class->GetName());
+		return nullptr;
+	}
+
+	FActorSpawnParameters Params = Awaiter.Params;
+	Params.bDeferConstruction = true;
+	AActor* Actor = GetWorld()->SpawnActor(Class, &Awaiter.Transform, Params);
+	if (!Actor)
+		return nullptr;
+
+	if (Awaiter.Initialize)
+		Awaiter.Initialize(Actor);
+	Actor->FinishSpawning(Awaiter.Transform);
+	return IsValid(Actor) ? Actor : nullptr;
+}
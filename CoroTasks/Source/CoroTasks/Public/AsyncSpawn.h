@@ -0,0 +1,184 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CoroScheduler.h"
+#include "Engine/World.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AsyncSpawn.generated.h"
+
+class UCoroSpawnSubsystem;
+struct FStreamableHandle;
+
+namespace CoroTasks
+{
+	/** Returns spawned actor, nullptr if class failed to load, spawn failed or Params reference destroyed objects */
+	class COROTASKS_API FSpawnActorAwaiter
+	{
+	public:
+		FSpawnActorAwaiter(UWorld* World, const TSoftClassPtr<AActor>& InClass, const FTransform& InTransform, const FActorSpawnParameters& InParams,
+			float InPriority, TFunction<void(AActor*)>&& InInitialize);
+
+		/** Lives in the awaiting frame and is bound by address */
+		FSpawnActorAwaiter(const FSpawnActorAwaiter&) = delete;
+		FSpawnActorAwaiter& operator=(const FSpawnActorAwaiter&) = delete;
+
+		/** Coroutine destroyed while waiting: class loading is cancelled, request leaves the queue */
+		~FSpawnActorAwaiter();
+
+		bool await_ready() const
+		{
+			return !Subsystem.IsValid();
+		}
+
+		void await_suspend(std::coroutine_handle<> Handle);
+
+		AActor* await_resume() const
+		{
+			return Actor;
+		}
+
+	private:
+		friend UCoroSpawnSubsystem;
+
+		struct FOrder
+		{
+			/** Higher priority first, equal ones in order of request */
+			bool operator()(const FSpawnActorAwaiter& A, const FSpawnActorAwaiter& B) const
+			{
+				return A.Priority > B.Priority || (A.Priority == B.Priority && A.Sequence < B.Sequence);
+			}
+		};
+
+		void OnClassLoaded();
+
+		/** Raw pointers of Params may dangle after frames in the queue */
+		bool AreParamsAlive() const;
+
+		TWeakObjectPtr<UCoroSpawnSubsystem> Subsystem;
+		TSoftClassPtr<AActor> Class;
+		FTransform Transform;
+		FActorSpawnParameters Params;
+		TWeakObjectPtr<AActor> Owner;
+		TWeakObjectPtr<APawn> Instigator;
+		TWeakObjectPtr<ULevel> OverrideLevel;
+		TWeakObjectPtr<AActor> Template;
+		TFunction<void(AActor*)> Initialize;
+		/** Kept until the actor finished spawning, so the loaded class isn't released meanwhile */
+		TSharedPtr<FStreamableHandle> LoadHandle;
+		AActor* Actor;
+		FContinuation Continuation;
+		float Priority;
+		uint64 Sequence;
+		bool bQueued;
+	};
+
+	template<typename T>
+	class TSpawnActorAwaiter : public FSpawnActorAwaiter
+	{
+	public:
+		using FSpawnActorAwaiter::FSpawnActorAwaiter;
+
+		T* await_resume() const
+		{
+			return Cast<T>(FSpawnActorAwaiter::await_resume());
+		}
+	};
+}
+
+/**
+ * Tour to async spawning:
+ * SpawnActorAsync loads the class if it's not loaded yet and puts the request into the spawn queue of the world.
+ * Each frame the queue spawns requests, highest priority first, until "CoroTasks.SpawnBudgetMs" is spent (at least one per frame),
+ * so a wave of spawns is amortized over frames instead of a hitch from construction scripts and BeginPlay.
+ * Actor is spawned deferred: optional Initialize runs before construction script and BeginPlay, then spawning is finished.
+ * Awaiting coroutine is resumed right after its actor is spawned. When the world is torn down pending requests are never resumed
+ *
+ * Use case:
+ *	>>> const float Priority = -FVector::Dist(SpawnPoint.GetLocation(), PlayerLocation);	// near-player spawns go first
+ *	>>> AEnemy* Enemy = co_await CoroTasks::SpawnActorAsync(GetWorld(), EnemyClass, SpawnPoint, {}, Priority, [&](AEnemy* Deferred)
+ *	>>> {
+ *	>>>		Deferred->Wave = WaveIndex;
+ *	>>> });
+ */
+UCLASS()
+class COROTASKS_API UCoroSpawnSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// BEGIN UTickableWorldSubsystem
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	// END UTickableWorldSubsystem
+
+	int32 GetNumQueued() const
+	{
+		return Queue.Num();
+	}
+
+private:
+	friend CoroTasks::FSpawnActorAwaiter;
+
+	void Enqueue(CoroTasks::FSpawnActorAwaiter* Awaiter);
+	void Dequeue(CoroTasks::FSpawnActorAwaiter* Awaiter);
+
+	AActor* Spawn(CoroTasks::FSpawnActorAwaiter& Awaiter);
+
+	/** Heap by FSpawnActorAwaiter::FOrder */
+	TArray<CoroTasks::FSpawnActorAwaiter*> Queue;
+
+	uint64 Sequence = 0;
+
+	bool bDeinitialized = false;
+};
+
+namespace CoroTasks
+{
+	/** See UCoroSpawnSubsystem. Priority is relative, higher spawns first. Game thread only */
+	template<typename T>
+	TSpawnActorAwaiter<T> SpawnActorAsync(UWorld* World, const TSoftClassPtr<T>& Class, const FTransform& Transform,
+		const FActorSpawnParameters& Params = FActorSpawnParameters(), float Priority = 0.f, TFunction<void(std::type_identity_t<T>*)> Initialize = nullptr)
+	{
+		TFunction<void(AActor*)> InitializeActor;
+		if (Initialize)
+		{
+			InitializeActor = [Initialize = MoveTemp(Initialize)](AActor* Actor)
+			{
+				Initialize(CastChecked<T>(Actor));
+			};
+		}
+		return TSpawnActorAwaiter<T>(World, TSoftClassPtr<AActor>(Class.ToSoftObjectPath()), Transform, Params, Priority, MoveTemp(InitializeActor));
+	}
+
+	template<typename T>
+	TSpawnActorAwaiter<T> SpawnActorAsync(UWorld* World, TSubclassOf<T> Class, const FTransform& Transform,
+		const FActorSpawnParameters& Params = FActorSpawnParameters(), float Priority = 0.f, TFunction<void(std::type_identity_t<T>*)> Initialize = nullptr)
+	{
+		return SpawnActorAsync<T>(World, TSoftClassPtr<T>(Class.Get()), Transform, Params, Priority, MoveTemp(Initialize));
+	}
+}
@@ -0,0 +1,224 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncSync.h"
+
+using namespace CoroTasks;
+
+void Private::ResumeWaiters(FAsyncWaiterQueue& Waiters, FCriticalSection& CriticalSection)
+{
+	for (;;)
+	{
+		FContinuation Continuation;
+		{
+			FScopeLock Lock(&CriticalSection);
+			FAsyncWaiter* Waiter = Waiters.Head;
+			if (Waiter == nullptr)
+				return;
+
+			// Queued while the waiter is still linked: cancel of its frame waits for the lock and then drops the queued resume
+			if (Waiter->Continuation.NeedsDispatch())
+				Waiter->Continuation.Resume();
+			else
+				Continuation = Waiter->Continuation;
+			Waiters.Pop();
+		}
+		if (Continuation.IsValid())
+			Continuation.Resume();
+	}
+}
+
+FAsyncSemaphoreScope::~FAsyncSemaphoreScope()
+{
+	Release();
+}
+
+void FAsyncSemaphoreScope::Release()
+{
+	if (Semaphore)
+	{
+		Semaphore->Release();
+		Semaphore = nullptr;
+	}
+}
+
+FAsyncSemaphore::FAsyncSemaphore(int32 InitialCount)
+	: Count(InitialCount)
+{
+	check(InitialCount >= 0);
+}
+
+FAsyncSemaphore::~FAsyncSemaphore()
+{
+	ensureMsgf(Waiters.IsEmpty(), TEXT("Semaphore destroyed while coroutines are waiting for it"));
+}
+
+bool FAsyncSemaphore::TryAcquire()
+{
+	FScopeLock Lock(&CriticalSection);
+	if (Count > 0)
+	{
+		--Count;
+		return true;
+	}
+	return false;
+}
+
+void FAsyncSemaphore::Release(int32 InCount)
+{
+	check(InCount > 0);
+	Private::FAsyncWaiterQueue ToResume;
+	{
+		FScopeLock Lock(&CriticalSection);
+		for (; InCount > 0; --InCount)
+		{
+			Private::FAsyncWaiter* Waiter = Waiters.Pop();
+			if (Waiter == nullptr)
+				break;
+			ToResume.Push(Waiter);
+		}
+		Count += InCount;
+	}
+	Private::ResumeWaiters(ToResume, CriticalSection);
+}
+
+int32 FAsyncSemaphore::GetAvailableCount() const
+{
+	FScopeLock Lock(&CriticalSection);
+	return Count;
+}
+
+bool FAsyncSemaphore::Enqueue(Private::FAsyncWaiter& Waiter, std::coroutine_handle<> Handle)
+{
+	FScopeLock Lock(&CriticalSection);
+	if (Count > 0)
+	{
+		--Count;
+		return false;
+	}
+	Waiter.Continuation = FContinuation::Capture(Handle, TEXT("FAsyncSemaphore"));
+	Waiters.Push(&Waiter);
+	return true;
+}
+
+void FAsyncSemaphore::Unlink(Private::FAsyncWaiter& Waiter)
+{
+	bool bHandedPermit = false;
+	{
+		FScopeLock Lock(&CriticalSection);
+		Private::FAsyncWaiterQueue* Queue = Waiter.Queue.load(std::memory_order_relaxed);
+		if (Queue == nullptr)
+			return;
+		Queue->Remove(&Waiter);
+		bHandedPermit = Queue != &Waiters;
+	}
+	// Permit was taken for this waiter by Release that is still resuming, it goes to the next one
+	if (bHandedPermit)
+		Release();
+}
+
+FAsyncEvent::FAsyncEvent(EEventMode InMode, bool bInitiallyTriggered)
+	: Mode(InMode)
+	, bTriggered(bInitiallyTriggered)
+{
+}
+
+FAsyncEvent::~FAsyncEvent()
+{
+	ensureMsgf(Waiters.IsEmpty(), TEXT("Event destroyed while coroutines are waiting for it"));
+}
+
+void FAsyncEvent::Trigger()
+{
+	Private::FAsyncWaiterQueue ToResume;
+	{
+		FScopeLock Lock(&CriticalSection);
+		if (Mode == EEventMode::ManualReset)
+		{
+			bTriggered = true;
+			while (Private::FAsyncWaiter* Waiter = Waiters.Pop())
+				ToResume.Push(Waiter);
+		}
+		else if (Private::FAsyncWaiter* Waiter = Waiters.Pop())
+		{
+			ToResume.Push(Waiter);
+		}
+		else
+		{
+			bTriggered = true;
+		}
+	}
+	Private::ResumeWaiters(ToResume, CriticalSection);
+}
+
+void FAsyncEvent::Reset()
+{
+	FScopeLock Lock(&CriticalSection);
+	bTriggered = false;
+}
+
+bool FAsyncEvent::IsTriggered() const
+{
+	FScopeLock Lock(&CriticalSection);
+	return bTriggered;
+}
+
+bool FAsyncEvent::TryConsume()
+{
+	FScopeLock Lock(&CriticalSection);
+	if (!bTriggered)
+		return false;
+	if (Mode == EEventMode::AutoReset)
+		bTriggered = false;
+	return true;
+}
+
+bool FAsyncEvent::Enqueue(Private::FAsyncWaiter& Waiter, std::coroutine_handle<> Handle)
+{
+	FScopeLock Lock(&CriticalSection);
+	if (bTriggered)
+	{
+		if (Mode == EEventMode::AutoReset)
+			bTriggered = false;
+		return false;
+	}
+	Waiter.Continuation = FContinuation::Capture(Handle, TEXT("FAsyncEvent"));
+	Waiters.Push(&Waiter);
+	return true;
+}
+
+void FAsyncEvent::Unlink(Private::FAsyncWaiter& Waiter)
+{
+	bool bHandedTrigger = false;
+	{
+		FScopeLock Lock(&CriticalSection);
+		Private::FAsyncWaiterQueue* Queue = Waiter.Queue.load(std::memory_order_relaxed);
+		if (Queue == nullptr)
+			return;
+		Queue->Remove(&Waiter);
+		bHandedTrigger = Queue != &Waiters && Mode == EEventMode::AutoReset;
+	}
+	// Auto reset trigger was consumed for this waiter, it goes to the next one
+	if (bHandedTrigger)
+		Trigger();
+}
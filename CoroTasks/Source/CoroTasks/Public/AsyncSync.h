@@ -0,0 +1,345 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "HAL/Event.h"
+#include "CoroScheduler.h"
+
+/**
+ * Tour to synchronization primitives:
+ * Coroutine-aware primitives suspend the awaiting coroutine instead of blocking the thread.
+ * Waiters are linked into intrusive FIFO queue (nodes live in awaiting frames), so there is no allocation and no polling.
+ * Cancelled waiter unlinks itself, a permit or an auto reset trigger already handed to it goes to the next waiter
+ * (unless its resume was already queued to the game thread: the resume is dropped, the permit stays taken).
+ *	1. FAsyncSemaphore	- limits count of coroutines that are inside of some section
+ *	2. FAsyncMutex		- semaphore with single permit, co_await returns scoped lock
+ *	3. FAsyncEvent		- manual or auto reset event
+ *
+ * Use case:
+ *	>>> static CoroTasks::FAsyncSemaphore HeavyLoads(8);
+ *	>>> {
+ *	>>>		auto Permit = co_await HeavyLoads.AcquireScoped();
+ *	>>>		UObject* Object = co_await CoroTasks::LoadSingleObject(Asset);
+ *	>>> }	// permit is released here and next waiter continues
+ *
+ *	>>> auto Lock = co_await SaveMutex.Lock();
+ */
+namespace CoroTasks
+{
+	namespace Private
+	{
+		struct FAsyncWaiterQueue;
+
+		struct FAsyncWaiter
+		{
+			FAsyncWaiter()
+				: Prev(nullptr)
+				, Next(nullptr)
+				, Queue(nullptr)
+			{}
+
+			/** Lives in the awaiting frame and is linked by address */
+			FAsyncWaiter(const FAsyncWaiter&) = delete;
+			FAsyncWaiter& operator=(const FAsyncWaiter&) = delete;
+
+			/** Checked without the lock by destructors of awaiters that never suspended or were already resumed */
+			bool IsLinked() const
+			{
+				return Queue.load(std::memory_order_acquire) != nullptr;
+			}
+
+			FAsyncWaiter* Prev;
+			FAsyncWaiter* Next;
+			/** Queue of the owner or of the caller that is resuming the waiter, changed under the lock of the owner */
+			std::atomic<FAsyncWaiterQueue*> Queue;
+			FContinuation Continuation;
+		};
+
+		/** Intrusive doubly linked FIFO queue, destroyed waiters remove themselves. Is not thread safe itself, guarded by owner */
+		struct FAsyncWaiterQueue
+		{
+			FAsyncWaiterQueue()
+				: Head(nullptr)
+				, Tail(nullptr)
+			{}
+
+			bool IsEmpty() const
+			{
+				return Head == nullptr;
+			}
+
+			void Push(FAsyncWaiter* Waiter)
+			{
+				Waiter->Prev = Tail;
+				Waiter->Next = nullptr;
+				if (Tail)
+					Tail->Next = Waiter;
+				else
+					Head = Waiter;
+				Tail = Waiter;
+				Waiter->Queue.store(this, std::memory_order_release);
+			}
+
+			FAsyncWaiter* Pop()
+			{
+				FAsyncWaiter* Waiter = Head;
+				if (Waiter)
+					Remove(Waiter);
+				return Waiter;
+			}
+
+			void Remove(FAsyncWaiter* Waiter)
+			{
+				check(Waiter->Queue.load(std::memory_order_relaxed) == this);
+				if (Waiter->Prev)
+					Waiter->Prev->Next = Waiter->Next;
+				else
+					Head = Waiter->Next;
+				if (Waiter->Next)
+					Waiter->Next->Prev = Waiter->Prev;
+				else
+					Tail = Waiter->Prev;
+				Waiter->Prev = Waiter->Next = nullptr;
+				Waiter->Queue.store(nullptr, std::memory_order_release);
+			}
+
+			FAsyncWaiter* Head;
+			FAsyncWaiter* Tail;
+		};
+
+		/**
+		 * Resumes waiters the caller took from the owner. Each one is popped under the lock of the owner,
+		 * so a waiter destroyed by resume of the previous one has already removed itself
+		 */
+		COROTASKS_API void ResumeWaiters(FAsyncWaiterQueue& Waiters, FCriticalSection& CriticalSection);
+	}
+
+	class FAsyncSemaphore;
+
+	/** Releases semaphore permit when goes out of scope */
+	class UE_NODISCARD COROTASKS_API FAsyncSemaphoreScope
+	{
+	public:
+		explicit FAsyncSemaphoreScope(FAsyncSemaphore& InSemaphore)
+			: Semaphore(&InSemaphore)
+		{}
+
+		FAsyncSemaphoreScope(FAsyncSemaphoreScope&& Other)
+			: Semaphore(Other.Semaphore)
+		{
+			Other.Semaphore = nullptr;
+		}
+
+		FAsyncSemaphoreScope(const FAsyncSemaphoreScope&) = delete;
+		FAsyncSemaphoreScope& operator=(const FAsyncSemaphoreScope&) = delete;
+
+		~FAsyncSemaphoreScope();
+
+		/** Releases permit before the end of scope */
+		void Release();
+
+	private:
+		FAsyncSemaphore* Semaphore;
+	};
+
+	class COROTASKS_API FAsyncSemaphore
+	{
+	public:
+		explicit FAsyncSemaphore(int32 InitialCount);
+		~FAsyncSemaphore();
+
+		FAsyncSemaphore(const FAsyncSemaphore&) = delete;
+		FAsyncSemaphore& operator=(const FAsyncSemaphore&) = delete;
+
+		struct FAcquireAwaiter : Private::FAsyncWaiter
+		{
+			explicit FAcquireAwaiter(FAsyncSemaphore& InSemaphore)
+				: Semaphore(InSemaphore)
+			{}
+
+			~FAcquireAwaiter()
+			{
+				if (IsLinked())
+					Semaphore.Unlink(*this);
+			}
+
+			bool await_ready()
+			{
+				return Semaphore.TryAcquire();
+			}
+
+			bool await_suspend(std::coroutine_handle<> Handle)
+			{
+				return Semaphore.Enqueue(*this, Handle);
+			}
+
+			void await_resume()
+			{
+			}
+
+		protected:
+			FAsyncSemaphore& Semaphore;
+		};
+
+		struct FScopedAcquireAwaiter : FAcquireAwaiter
+		{
+			using FAcquireAwaiter::FAcquireAwaiter;
+
+			FAsyncSemaphoreScope await_resume()
+			{
+				return FAsyncSemaphoreScope(Semaphore);
+			}
+		};
+
+		/** Awaits for a permit. Caller is responsible to call Release */
+		FAcquireAwaiter Acquire()
+		{
+			return FAcquireAwaiter(*this);
+		}
+
+		/** Awaits for a permit that will be released automatically */
+		FScopedAcquireAwaiter AcquireScoped()
+		{
+			return FScopedAcquireAwaiter(*this);
+		}
+
+		bool TryAcquire();
+
+		/** Returns permits. Each permit is handed to the oldest waiter directly, so it can't be stolen by a newcomer */
+		void Release(int32 InCount = 1);
+
+		int32 GetAvailableCount() const;
+
+	private:
+		bool Enqueue(Private::FAsyncWaiter& Waiter, std::coroutine_handle<> Handle);
+		void Unlink(Private::FAsyncWaiter& Waiter);
+
+		mutable FCriticalSection CriticalSection;
+		Private::FAsyncWaiterQueue Waiters;
+		int32 Count;
+	};
+
+	using FAsyncMutexLock = FAsyncSemaphoreScope;
+
+	class COROTASKS_API FAsyncMutex
+	{
+	public:
+		FAsyncMutex()
+			: Semaphore(1)
+		{}
+
+		/** Awaits for ownership. Returns FAsyncMutexLock that unlocks mutex in destructor */
+		FAsyncSemaphore::FScopedAcquireAwaiter Lock()
+		{
+			return Semaphore.AcquireScoped();
+		}
+
+		bool TryLock()
+		{
+			return Semaphore.TryAcquire();
+		}
+
+		/** Should be called only after successful TryLock */
+		void Unlock()
+		{
+			Semaphore.Release();
+		}
+
+		bool IsLocked() const
+		{
+			return Semaphore.GetAvailableCount() == 0;
+		}
+
+	private:
+		FAsyncSemaphore Semaphore;
+	};
+
+	class COROTASKS_API FAsyncEvent
+	{
+	public:
+		explicit FAsyncEvent(EEventMode InMode = EEventMode::ManualReset, bool bInitiallyTriggered = false);
+		~FAsyncEvent();
+
+		FAsyncEvent(const FAsyncEvent&) = delete;
+		FAsyncEvent& operator=(const FAsyncEvent&) = delete;
+
+		struct FWaitAwaiter : Private::FAsyncWaiter
+		{
+			explicit FWaitAwaiter(FAsyncEvent& InEvent)
+				: Event(InEvent)
+			{}
+
+			~FWaitAwaiter()
+			{
+				if (IsLinked())
+					Event.Unlink(*this);
+			}
+
+			bool await_ready()
+			{
+				return Event.TryConsume();
+			}
+
+			bool await_suspend(std::coroutine_handle<> Handle)
+			{
+				return Event.Enqueue(*this, Handle);
+			}
+
+			void await_resume()
+			{
+			}
+
+		private:
+			FAsyncEvent& Event;
+		};
+
+		FWaitAwaiter Wait()
+		{
+			return FWaitAwaiter(*this);
+		}
+
+		/**
+		 * Manual reset: resumes all waiters and keeps event triggered until Reset
+		 * Auto reset: resumes the oldest waiter or keeps event triggered until next Wait
+		 */
+		void Trigger();
+
+		void Reset();
+
+		bool IsTriggered() const;
+
+	private:
+		bool TryConsume();
+		bool Enqueue(Private::FAsyncWaiter& Waiter, std::coroutine_handle<> Handle);
+		void Unlink(Private::FAsyncWaiter& Waiter);
+
+		mutable FCriticalSection CriticalSection;
+		Private::FAsyncWaiterQueue Waiters;
+		EEventMode Mode;
+		bool bTriggered;
+	};
+}
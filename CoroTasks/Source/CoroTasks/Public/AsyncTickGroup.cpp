@@ -0,0 +1,136 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncTickGroup.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+
+using namespace CoroTasks;
+
+FNextTickAwaiter::FNextTickAwaiter(UWorld* World, ETickingGroup Group)
+	: TickFunction(nullptr)
+	, DeltaTime(0.f)
+	, bWaiting(false)
+{
+	check(IsInGameThread());
+	checkf(Group < TG_NewlySpawned, TEXT("TG_NewlySpawned is not a tick group to wait for"));
+	UCoroTickGroupSubsystem* Subsystem = World ? World->GetSubsystem<UCoroTickGroupSubsystem>() : nullptr;
+	if (ensureMsgf(Subsystem, TEXT("Waiting for tick of a world without UCoroTickGroupSubsystem, wait is resumed immediately")))
+		TickFunction = &Subsystem->GetTickFunction(Group);
+}
+
+FNextTickAwaiter::~FNextTickAwaiter()
+{
+	if (!bWaiting || !TickFunction)
+		return;
+
+	if (TickFunction->Queue.RemoveSingle(this) == 0)
+	{
+		const int32 Index = TickFunction->Draining.Find(this);
+		if (Index != INDEX_NONE)
+			TickFunction->Draining[Index] = nullptr;
+	}
+}
+
+void FNextTickAwaiter::await_suspend(std::coroutine_handle<> Handle)
+{
+	Continuation = FContinuation::Capture(Handle, TEXT("NextTick"));
+	bWaiting = true;
+	TickFunction->Queue.Add(this);
+}
+
+
+void FCoroTickGroupFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	// Function registered mid-frame is run in the newly spawned pass of the current group, its waits belong to the real one
+	if (GFrameCounter < FirstFrame)
+		return;
+
+	// Waits added by resumed coroutines are for the next frame
+	check(Draining.IsEmpty());
+	Swap(Draining, Queue);
+	for (int32 Index = 0; Index < Draining.Num(); ++Index)
+	{
+		if (FNextTickAwaiter* Awaiter = Draining[Index])
+		{
+			Draining[Index] = nullptr;
+			Awaiter->bWaiting = false;
+			Awaiter->DeltaTime = DeltaTime;
+			Awaiter->Continuation.Resume();
+		}
+	}
+	Draining.Reset();
+}
+
+FString FCoroTickGroupFunction::DiagnosticMessage()
+{
+	return FString::Printf(TEXT("FCoroTickGroupFunction[%s] %s"), *UEnum::GetValueAsString(TickGroup.GetValue()), *GetNameSafe(World));
+}
+
+FName FCoroTickGroupFunction::DiagnosticContext(bool bDetailed)
+{
+	return FName(TEXT("CoroTasksNextTick"));
+}
+
+
+void UCoroTickGroupSubsystem::Deinitialize()
+{
+	for (FCoroTickGroupFunction& TickFunction : TickFunctions)
+	{
+		for (FNextTickAwaiter* Awaiter : TickFunction.Queue)
+			Awaiter->TickFunction = nullptr;
+		for (FNextTickAwaiter* Awaiter : TickFunction.Draining)
+		{
+			if (Awaiter)
+				Awaiter->TickFunction = nullptr;
+		}
+		TickFunction.Queue.Reset();
+		TickFunction.Draining.Reset();
+		if (TickFunction.IsTickFunctionRegistered())
+			TickFunction.UnRegisterTickFunction();
+	}
+	Super::Deinitialize();
+}
+
+FCoroTickGroupFunction& UCoroTickGroupSubsystem::GetTickFunction(ETickingGroup Group)
+{
+	FCoroTickGroupFunction& TickFunction = TickFunctions[Group];
+	if (!TickFunction.IsTickFunctionRegistered())
+	{
+		UWorld* World = GetWorld();
+		TickFunction.World = World;
+		TickFunction.bCanEverTick = true;
+		TickFunction.bStartWithTickEnabled = true;
+		TickFunction.bAllowTickOnDedicatedServer = true;
+		TickFunction.TickGroup = Group;
+		TickFunction.EndTickGroup = Group;
+		TickFunction.FirstFrame = World->bInTick ? GFrameCounter + 1 : GFrameCounter;
+		TickFunction.RegisterTickFunction(World->PersistentLevel);
+	}
+	return TickFunction;
+}
+
+FNextTickAwaiter CoroTasks::NextTick(UWorld* World, ETickingGroup Group)
+{
+	return FNextTickAwaiter(World, Group);
+}
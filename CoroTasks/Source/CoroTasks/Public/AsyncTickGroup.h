@@ -0,0 +1,141 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CoroScheduler.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AsyncTickGroup.generated.h"
+
+class UCoroTickGroupSubsystem;
+struct FCoroTickGroupFunction;
+
+namespace CoroTasks
+{
+	/** Suspends until the world ticks the group. Returns DeltaTime of that tick (0 if not suspended) */
+	class COROTASKS_API FNextTickAwaiter
+	{
+	public:
+		FNextTickAwaiter(UWorld* World, ETickingGroup Group);
+
+		/** Lives in the awaiting frame and is bound by address */
+		FNextTickAwaiter(const FNextTickAwaiter&) = delete;
+		FNextTickAwaiter& operator=(const FNextTickAwaiter&) = delete;
+
+		/** Coroutine destroyed while waiting: leaves the queue */
+		~FNextTickAwaiter();
+
+		bool await_ready() const
+		{
+			return TickFunction == nullptr;
+		}
+
+		void await_suspend(std::coroutine_handle<> Handle);
+
+		float await_resume() const
+		{
+			return DeltaTime;
+		}
+
+	private:
+		friend UCoroTickGroupSubsystem;
+		friend FCoroTickGroupFunction;
+
+		/** Nulled when world is torn down */
+		FCoroTickGroupFunction* TickFunction;
+		FContinuation Continuation;
+		float DeltaTime;
+		bool bWaiting;
+	};
+}
+
+/** One per tick group of a world, drains its own queue of waits */
+USTRUCT()
+struct FCoroTickGroupFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	// BEGIN FTickFunction
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+	// END FTickFunction
+
+	UWorld* World = nullptr;
+
+	/** Frame of the first run in the right group */
+	uint64 FirstFrame = 0;
+
+	/** In order of waiting */
+	TArray<CoroTasks::FNextTickAwaiter*> Queue;
+
+	/** Waits of the current tick, destroyed ones are nulled */
+	TArray<CoroTasks::FNextTickAwaiter*> Draining;
+};
+
+template<>
+struct TStructOpsTypeTraits<FCoroTickGroupFunction> : public TStructOpsTypeTraitsBase2<FCoroTickGroupFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Tour to tick groups:
+ * UCoroTasksSubsystem resumes from the core ticker, outside of the world tick. NextTick resumes inside of the world tick instead,
+ * in the requested group, so e.g. post-physics transforms are read in the same frame. Each group has its own tick function per world,
+ * registered on the first wait in it and kept enabled afterwards: enabling it mid-frame would run it in the newly spawned pass, out of its group.
+ * So the very first wait in a group, if issued during the world tick, resumes a frame later.
+ * Waits issued before the group ticks resume in this frame, waits issued while it ticks (or later) resume in the next frame.
+ * Like actors, groups don't tick while the world is paused. When the world is torn down pending waits are never resumed
+ *
+ * Use case:
+ *	>>> co_await CoroTasks::NextTick(GetWorld(), TG_PostPhysics);
+ *	>>> const FTransform Settled = Mesh->GetComponentTransform();
+ */
+UCLASS()
+class COROTASKS_API UCoroTickGroupSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// BEGIN UWorldSubsystem
+	virtual void Deinitialize() override;
+	// END UWorldSubsystem
+
+	/** Registers tick function of the group if it's the first wait in it */
+	FCoroTickGroupFunction& GetTickFunction(ETickingGroup Group);
+
+private:
+	FCoroTickGroupFunction TickFunctions[TG_NewlySpawned];
+};
+
+namespace CoroTasks
+{
+	/** Resumes awaiting coroutine when World ticks Group (game thread only). See UCoroTickGroupSubsystem */
+	COROTASKS_API FNextTickAwaiter NextTick(UWorld* World, ETickingGroup Group = TG_PrePhysics);
+}
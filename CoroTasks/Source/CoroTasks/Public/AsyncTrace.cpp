@@ -0,0 +1,96 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AsyncTrace.h"
+
+using namespace CoroTasks;
+
+namespace CoroTasks::Private
+{
+	/** UserData is the index here, handle check protects from result of cancelled query landing in a reused slot */
+	static TSparseArray<FAsyncQueryAwaiter_Base*> AsyncQueryAwaiters;
+}
+
+const FTraceDelegate Private::FAsyncTraceDispatcher::TraceDelegate = FTraceDelegate::CreateStatic(&FAsyncTraceDispatcher::OnTraceDone);
+const FOverlapDelegate Private::FAsyncTraceDispatcher::OverlapDelegate = FOverlapDelegate::CreateStatic(&FAsyncTraceDispatcher::OnOverlapDone);
+
+int32 Private::FAsyncTraceDispatcher::Add(FAsyncQueryAwaiter_Base* Awaiter)
+{
+	check(IsInGameThread());
+	return AsyncQueryAwaiters.Add(Awaiter);
+}
+
+void Private::FAsyncTraceDispatcher::Remove(int32 UserData)
+{
+	check(IsInGameThread());
+	AsyncQueryAwaiters.RemoveAt(UserData);
+}
+
+Private::FAsyncQueryAwaiter_Base* Private::FAsyncTraceDispatcher::Find(int32 UserData, const FTraceHandle& Handle)
+{
+	if (!AsyncQueryAwaiters.IsValidIndex(UserData))
+		return nullptr;
+
+	FAsyncQueryAwaiter_Base* Awaiter = AsyncQueryAwaiters[UserData];
+	return Awaiter->Handle == Handle ? Awaiter : nullptr;
+}
+
+void Private::FAsyncTraceDispatcher::OnTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	if (FAsyncQueryAwaiter_Base* Awaiter = Find(static_cast<int32>(Datum.UserData), Handle))
+		Awaiter->OnTraceDone(Datum);
+}
+
+void Private::FAsyncTraceDispatcher::OnOverlapDone(const FTraceHandle& Handle, FOverlapDatum& Datum)
+{
+	if (FAsyncQueryAwaiter_Base* Awaiter = Find(static_cast<int32>(Datum.UserData), Handle))
+		Awaiter->OnOverlapDone(Datum);
+}
+
+void FAsyncTraceAwaiter::await_suspend(std::coroutine_handle<> InHandle)
+{
+	Continuation = FContinuation::Capture(InHandle, TEXT("AsyncTrace"));
+	UserData = Private::FAsyncTraceDispatcher::Add(this);
+	Handle = bSweep
+		? World->AsyncSweepByChannel(Type, Start, End, Rot, Channel, Shape, Params, ResponseParams, &Private::FAsyncTraceDispatcher::TraceDelegate, static_cast<uint32>(UserData))
+		: World->AsyncLineTraceByChannel(Type, Start, End, Channel, Params, ResponseParams, &Private::FAsyncTraceDispatcher::TraceDelegate, static_cast<uint32>(UserData));
+}
+
+void FAsyncTraceAwaiter::OnTraceDone(FTraceDatum& Datum)
+{
+	Hits = MoveTemp(Datum.OutHits);
+	Finish();
+}
+
+void FAsyncOverlapAwaiter::await_suspend(std::coroutine_handle<> InHandle)
+{
+	Continuation = FContinuation::Capture(InHandle, TEXT("AsyncOverlap"));
+	UserData = Private::FAsyncTraceDispatcher::Add(this);
+	Handle = World->AsyncOverlapByChannel(Position, Rot, Channel, Shape, Params, ResponseParams, &Private::FAsyncTraceDispatcher::OverlapDelegate, static_cast<uint32>(UserData));
+}
+
+void FAsyncOverlapAwaiter::OnOverlapDone(FOverlapDatum& Datum)
+{
+	Overlaps = MoveTemp(Datum.OutOverlaps);
+	Finish();
+}
@@ -0,0 +1,202 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "CoroScheduler.h"
+#include "Engine/World.h"
+#include "WorldCollision.h"
+
+/**
+ * Tour to async traces:
+ * Traces ride the world async trace batch: they are issued on await, run with the physics scene
+ * and results come next frame. All awaiters share one FTraceDelegate and one FOverlapDelegate, the waiter is found by UserData,
+ * so there is no delegate binding per trace. Destroyed (cancelled) awaiter just drops its result
+ *	1. AsyncLineTrace	- returns hits (single or multi, see EAsyncTraceType)
+ *	2. AsyncSweep		- same for shape sweep
+ *	3. AsyncOverlap		- returns overlaps
+ *
+ * Use case:
+ *	>>> TArray<FHitResult> Hits = co_await CoroTasks::AsyncLineTrace(World, EAsyncTraceType::Single, EyeLocation, TargetLocation, ECC_Visibility);
+ *	>>> const bool bCanSee = Hits.IsEmpty() || Hits[0].GetActor() == Target;
+ */
+namespace CoroTasks
+{
+	namespace Private
+	{
+		class FAsyncQueryAwaiter_Base;
+
+		/** Game thread only, like async traces themselves */
+		class COROTASKS_API FAsyncTraceDispatcher
+		{
+		public:
+			/** Returns UserData to issue the query with */
+			static int32 Add(FAsyncQueryAwaiter_Base* Awaiter);
+			static void Remove(int32 UserData);
+
+			static const FTraceDelegate TraceDelegate;
+			static const FOverlapDelegate OverlapDelegate;
+
+		private:
+			static FAsyncQueryAwaiter_Base* Find(int32 UserData, const FTraceHandle& Handle);
+			static void OnTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+			static void OnOverlapDone(const FTraceHandle& Handle, FOverlapDatum& Datum);
+		};
+
+		class COROTASKS_API FAsyncQueryAwaiter_Base
+		{
+		public:
+			explicit FAsyncQueryAwaiter_Base(UWorld* InWorld)
+				: World(InWorld)
+				, UserData(INDEX_NONE)
+			{
+				ensureMsgf(World, TEXT("Async trace without world, it's resumed immediately without results"));
+			}
+
+			/** Lives in the awaiting frame and is found by address */
+			FAsyncQueryAwaiter_Base(const FAsyncQueryAwaiter_Base&) = delete;
+			FAsyncQueryAwaiter_Base& operator=(const FAsyncQueryAwaiter_Base&) = delete;
+
+			~FAsyncQueryAwaiter_Base()
+			{
+				if (UserData != INDEX_NONE)
+					FAsyncTraceDispatcher::Remove(UserData);
+			}
+
+			bool await_ready() const
+			{
+				return World == nullptr;
+			}
+
+		protected:
+			friend FAsyncTraceDispatcher;
+
+			virtual void OnTraceDone(FTraceDatum& Datum) {}
+			virtual void OnOverlapDone(FOverlapDatum& Datum) {}
+
+			void Finish()
+			{
+				FAsyncTraceDispatcher::Remove(UserData);
+				UserData = INDEX_NONE;
+				Continuation.Resume();
+			}
+
+			UWorld* World;
+			FTraceHandle Handle;
+			int32 UserData;
+			FContinuation Continuation;
+		};
+	}
+
+	class COROTASKS_API FAsyncTraceAwaiter : public Private::FAsyncQueryAwaiter_Base
+	{
+	public:
+		FAsyncTraceAwaiter(UWorld* InWorld, EAsyncTraceType InType, const FVector& InStart, const FVector& InEnd, const FQuat& InRot,
+			ECollisionChannel InChannel, const FCollisionShape& InShape, const FCollisionQueryParams& InParams, const FCollisionResponseParams& InResponseParams, bool bInSweep)
+			: FAsyncQueryAwaiter_Base(InWorld)
+			, Type(InType)
+			, Start(InStart)
+			, End(InEnd)
+			, Rot(InRot)
+			, Channel(InChannel)
+			, Shape(InShape)
+			, Params(InParams)
+			, ResponseParams(InResponseParams)
+			, bSweep(bInSweep)
+		{}
+
+		void await_suspend(std::coroutine_handle<> InHandle);
+
+		TArray<FHitResult> await_resume()
+		{
+			return MoveTemp(Hits);
+		}
+
+	protected:
+		virtual void OnTraceDone(FTraceDatum& Datum) override;
+
+		EAsyncTraceType Type;
+		FVector Start;
+		FVector End;
+		FQuat Rot;
+		ECollisionChannel Channel;
+		FCollisionShape Shape;
+		FCollisionQueryParams Params;
+		FCollisionResponseParams ResponseParams;
+		TArray<FHitResult> Hits;
+		bool bSweep;
+	};
+
+	class COROTASKS_API FAsyncOverlapAwaiter : public Private::FAsyncQueryAwaiter_Base
+	{
+	public:
+		FAsyncOverlapAwaiter(UWorld* InWorld, const FVector& InPosition, const FQuat& InRot, ECollisionChannel InChannel,
+			const FCollisionShape& InShape, const FCollisionQueryParams& InParams, const FCollisionResponseParams& InResponseParams)
+			: FAsyncQueryAwaiter_Base(InWorld)
+			, Position(InPosition)
+			, Rot(InRot)
+			, Channel(InChannel)
+			, Shape(InShape)
+			, Params(InParams)
+			, ResponseParams(InResponseParams)
+		{}
+
+		void await_suspend(std::coroutine_handle<> InHandle);
+
+		TArray<FOverlapResult> await_resume()
+		{
+			return MoveTemp(Overlaps);
+		}
+
+	protected:
+		virtual void OnOverlapDone(FOverlapDatum& Datum) override;
+
+		FVector Position;
+		FQuat Rot;
+		ECollisionChannel Channel;
+		FCollisionShape Shape;
+		FCollisionQueryParams Params;
+		FCollisionResponseParams ResponseParams;
+		TArray<FOverlapResult> Overlaps;
+	};
+
+	inline FAsyncTraceAwaiter AsyncLineTrace(UWorld* World, EAsyncTraceType Type, const FVector& Start, const FVector& End, ECollisionChannel Channel,
+		const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParams = FCollisionResponseParams::DefaultResponseParam)
+	{
+		return FAsyncTraceAwaiter(World, Type, Start, End, FQuat::Identity, Channel, FCollisionShape(), Params, ResponseParams, false);
+	}
+
+	inline FAsyncTraceAwaiter AsyncSweep(UWorld* World, EAsyncTraceType Type, const FVector& Start, const FVector& End, const FQuat& Rot, ECollisionChannel Channel,
+		const FCollisionShape& Shape, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParams = FCollisionResponseParams::DefaultResponseParam)
+	{
+		return FAsyncTraceAwaiter(World, Type, Start, End, Rot, Channel, Shape, Params, ResponseParams, true);
+	}
+
+	inline FAsyncOverlapAwaiter AsyncOverlap(UWorld* World, const FVector& Position, const FQuat& Rot, ECollisionChannel Channel, const FCollisionShape& Shape,
+		const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParams = FCollisionResponseParams::DefaultResponseParam)
+	{
+		return FAsyncOverlapAwaiter(World, Position, Rot, Channel, Shape, Params, ResponseParams);
+	}
+}
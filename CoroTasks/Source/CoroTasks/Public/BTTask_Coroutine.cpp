@@ -0,0 +1,111 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "BTTask_Coroutine.h"
+#include "AsyncException.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "CoroTasks.h"
+
+UBTTask_Coroutine::UBTTask_Coroutine(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	NodeName = TEXT("Coroutine");
+	bNotifyTick = false;
+	bCreateNodeInstance = false;
+}
+
+EBTNodeResult::Type UBTTask_Coroutine::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FBTCoroutineTaskMemory* Memory = CastInstanceNodeMemory<FBTCoroutineTaskMemory>(NodeMemory);
+	Memory->Result = EBTNodeResult::Failed;
+	Memory->bLatent = false;
+	Memory->bFinishing = false;
+	Memory->Task = RunAndFinish(&OwnerComp);
+	Memory->Task.Launch();
+	if (Memory->Task.IsDone())
+		return Memory->Result;
+
+	Memory->bLatent = true;
+	return EBTNodeResult::InProgress;
+}
+
+EBTNodeResult::Type UBTTask_Coroutine::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FBTCoroutineTaskMemory* Memory = CastInstanceNodeMemory<FBTCoroutineTaskMemory>(NodeMemory);
+	if (!Memory->bFinishing)
+		Memory->Task.Cancel();
+	return EBTNodeResult::Aborted;
+}
+
+uint16 UBTTask_Coroutine::GetInstanceMemorySize() const
+{
+	return sizeof(FBTCoroutineTaskMemory);
+}
+
+void UBTTask_Coroutine::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTCoroutineTaskMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_Coroutine::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	FBTCoroutineTaskMemory* Memory = CastInstanceNodeMemory<FBTCoroutineTaskMemory>(NodeMemory);
+	if (!Memory->bFinishing)
+		Memory->Task.Cancel();
+	CleanupNodeMemory<FBTCoroutineTaskMemory>(NodeMemory, CleanupType);
+}
+
+CoroTasks::TTask<> UBTTask_Coroutine::RunAndFinish(TWeakObjectPtr<UBehaviorTreeComponent> OwnerComp)
+{
+	EBTNodeResult::Type Result = EBTNodeResult::Failed;
+#if COROTASKS_WITH_EXCEPTIONS
+	try
+	{
+		Result = co_await ExecuteCoroutine(*OwnerComp);
+	}
+	catch (const FAsyncException& Exception)
+	{
+		UE_LOG(LogCoroTasks, Error, TEXT("%s failed: %s"), *GetNodeName(), *Exception.GetMessage());
+	}
+#else
+	auto TaskResult = co_await ExecuteCoroutine(*OwnerComp);
+	if (TaskResult.HasError())
+		UE_LOG(LogCoroTasks, Error, TEXT("%s failed: %s"), *GetNodeName(), *TaskResult.GetError().GetMessage());
+	else
+		Result = TaskResult.GetValue();
+#endif
+
+	// Memory is looked up again: instance memory may be moved while coroutine is suspended
+	UBehaviorTreeComponent* OwnerCompPtr = OwnerComp.Get();
+	uint8* NodeMemory = OwnerCompPtr ? OwnerCompPtr->GetNodeMemory(this, OwnerCompPtr->FindInstanceContainingNode(this)) : nullptr;
+	if (!NodeMemory)
+		co_return;
+
+	FBTCoroutineTaskMemory* Memory = CastInstanceNodeMemory<FBTCoroutineTaskMemory>(NodeMemory);
+	Memory->Result = Result;
+	if (Memory->bLatent)
+	{
+		Memory->bFinishing = true;
+		FinishLatentTask(*OwnerCompPtr, Result);
+	}
+}
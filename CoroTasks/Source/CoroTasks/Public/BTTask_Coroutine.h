@@ -0,0 +1,78 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "CoroTask.h"
+#include "BTTask_Coroutine.generated.h"
+
+struct FBTCoroutineTaskMemory
+{
+	/** Wraps ExecuteCoroutine and finishes latent task */
+	CoroTasks::TTask<> Task;
+	EBTNodeResult::Type Result = EBTNodeResult::Failed;
+	/** ExecuteTask has returned InProgress, so the result goes through FinishLatentTask */
+	bool bLatent = false;
+	/** FinishLatentTask is in progress, the coroutine can't be cancelled from inside of it */
+	bool bFinishing = false;
+};
+
+/**
+ * Tour to coroutine BT tasks:
+ * Base for latent BT tasks written as coroutines. The node doesn't tick: execution is the coroutine returned by ExecuteCoroutine,
+ * its result is returned right from ExecuteTask when it completes synchronously, otherwise it's passed to FinishLatentTask.
+ * On abort (and when node memory is cleaned up) the coroutine is cancelled: its frame is destroyed with all pending awaiters.
+ * Node is not instanced, so per-execution state should live in coroutine locals
+ *
+ * Use case:
+ *	>>> CoroTasks::TTask<EBTNodeResult::Type> UBTTask_Reload::ExecuteCoroutine(UBehaviorTreeComponent& OwnerComp)
+ *	>>> {
+ *	>>>		AWeapon* Weapon = GetWeapon(OwnerComp);
+ *	>>>		co_await CoroTasks::Delay(Weapon->ReloadTime);
+ *	>>>		Weapon->Refill();
+ *	>>>		co_return EBTNodeResult::Succeeded;
+ *	>>> }
+ */
+UCLASS(Abstract)
+class COROTASKS_API UBTTask_Coroutine : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_Coroutine(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+
+protected:
+	virtual CoroTasks::TTask<EBTNodeResult::Type> ExecuteCoroutine(UBehaviorTreeComponent& OwnerComp) PURE_VIRTUAL(UBTTask_Coroutine::ExecuteCoroutine, return {};);
+
+private:
+	CoroTasks::TTask<> RunAndFinish(TWeakObjectPtr<UBehaviorTreeComponent> OwnerComp);
+};
@@ -0,0 +1,55 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoroSupport.h"
+
+/**
+ * Tour to the core:
+ * Headers of Public/Core (tasks, futures, continuations, frame pool, results, generators) don't depend on the engine.
+ * Everything engine specific comes from an adapter that is selected here:
+ *	1. CoroUnrealAdapter.h		- Unreal build: check/ensure, FCoroError with FString, trace, registry, await latency,
+ *									frame stats and resumption on the game thread
+ *	2. CoroStandaloneAdapter.h	- COROTASKS_STANDALONE=1: plain C++20, used by CoroTasks/Standalone tests and benchmarks
+ *
+ * Adapter provides:
+ *	COROTASKS_CHECK(Expr), COROTASKS_ENSURE(Expr, "Message"), COROTASKS_TEXT("Literal"),
+ *	COROTASKS_TRACE(...), COROTASKS_TRACE_RESUME_SCOPE(Task), COROTASKS_REGISTRY(...),
+ *	COROTASKS_WITH_REGISTRY, COROTASKS_WITH_AWAIT_LATENCY,
+ *	CoroTasks::FCoroError, CoroTasks::FPooledFrame, CoroTasks::RegistryNodeSize,
+ *	CoroTasks::Core::FAwaitableName, CoroTasks::Core::IsInMainThread(), CoroTasks::Core::ResumeOnMainThread(Handle),
+ *	CoroTasks::Core::ForgetMainThreadResumes(FrameAddress)
+ */
+#ifndef COROTASKS_STANDALONE
+	#define COROTASKS_STANDALONE 0
+#endif
+
+#if COROTASKS_STANDALONE
+	#include "CoroStandaloneAdapter.h"
+#else
+	#include "CoroUnrealAdapter.h"
+#endif
+
+#define COROTASKS_JOIN_INNER(A, B) A##B
+#define COROTASKS_JOIN(A, B) COROTASKS_JOIN_INNER(A, B)
@@ -0,0 +1,208 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <optional>
+
+#include "CoroCoreConfig.h"
+
+/**
+ * Tour to errors:
+ * With exceptions enabled (COROTASKS_WITH_EXCEPTIONS=1) a failed task rethrows its exception in the awaiting coroutine.
+ * Without exceptions TTask<R> is awaited as TCoroResult<R>, and errors are propagated explicitly:
+ *	1. CORO_FAIL(Error)				- finishes current task with error
+ *	2. CORO_TRY(Var, Task)			- awaits the task, declares Var with its value or forwards its error to the caller
+ *	3. CORO_TRY_VOID(Task)			- the same for TTask<void>
+ * FCoroError is defined by the adapter (see CoroCoreConfig.h)
+ *
+ * These macros work in both configurations, so code written with them doesn't depend on the exceptions setting
+ * >>> CoroTasks::TTask<int32> GetPrice(TSoftObjectPtr<UCar> CarAsset)
+ * >>> {
+ * >>>		CORO_TRY(bIsFerrari, IsFerrariCar(CarAsset));
+ * >>>		if (!bIsFerrari)
+ * >>>			CORO_FAIL(FCoroError(TEXT("Only Ferrari is sold here")));
+ * >>>		co_return 100500;
+ * >>> }
+ */
+namespace CoroTasks
+{
+	/** Value or error of awaited task (it's like TValueOrError, but also works with void) */
+	template<typename R>
+	class TCoroResult
+	{
+	public:
+		TCoroResult(R&& InValue)
+			: Value(std::move(InValue))
+		{}
+
+		TCoroResult(FCoroError&& InError)
+			: Error(std::move(InError))
+		{}
+
+		bool HasValue() const
+		{
+			return Value.has_value();
+		}
+
+		bool HasError() const
+		{
+			return Error.has_value();
+		}
+
+		R& GetValue()
+		{
+			return Value.value();
+		}
+
+		const R& GetValue() const
+		{
+			return Value.value();
+		}
+
+		R StealValue()
+		{
+			R Result = std::move(Value.value());
+			Value.reset();
+			return Result;
+		}
+
+		const FCoroError& GetError() const
+		{
+			return Error.value();
+		}
+
+		FCoroError StealError()
+		{
+			FCoroError Result = std::move(Error.value());
+			Error.reset();
+			return Result;
+		}
+
+	private:
+		std::optional<R> Value;
+		std::optional<FCoroError> Error;
+	};
+
+	template<>
+	class TCoroResult<void>
+	{
+	public:
+		TCoroResult()
+		{}
+
+		TCoroResult(FCoroError&& InError)
+			: Error(std::move(InError))
+		{}
+
+		bool HasValue() const
+		{
+			return !Error.has_value();
+		}
+
+		bool HasError() const
+		{
+			return Error.has_value();
+		}
+
+		void GetValue() const
+		{
+			COROTASKS_CHECK(!Error.has_value());
+		}
+
+		void StealValue()
+		{
+			COROTASKS_CHECK(!Error.has_value());
+		}
+
+		const FCoroError& GetError() const
+		{
+			return Error.value();
+		}
+
+		FCoroError StealError()
+		{
+			FCoroError Result = std::move(Error.value());
+			Error.reset();
+			return Result;
+		}
+
+	private:
+		std::optional<FCoroError> Error;
+	};
+
+	/** Awaiting it never resumes: the task is finished with the error and its frame is destroyed */
+	struct FFailAwaiter
+	{
+		FCoroError Error;
+
+		bool await_ready()
+		{
+			return false;
+		}
+
+		template<typename PromiseType>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<PromiseType> Handle)
+		{
+			return Handle.promise().Fail(Handle, std::move(Error));
+		}
+
+		void await_resume()
+		{
+			COROTASKS_CHECK(false);
+		}
+	};
+
+	inline FFailAwaiter Fail(FCoroError Error)
+	{
+		return FFailAwaiter{std::move(Error)};
+	}
+}
+
+#if COROTASKS_WITH_EXCEPTIONS
+
+	#define CORO_FAIL(Error) throw (Error)
+
+	#define CORO_TRY(Var, Awaitable) auto Var = co_await (Awaitable)
+
+	#define CORO_TRY_VOID(Awaitable) co_await (Awaitable)
+
+#else
+
+	#define CORO_FAIL(Error) co_await CoroTasks::Fail(Error)
+
+	#define CORO_TRY(Var, Awaitable) \
+		auto COROTASKS_JOIN(CoroTryResult_, __LINE__) = co_await (Awaitable); \
+		if (COROTASKS_JOIN(CoroTryResult_, __LINE__).HasError()) \
+			co_await CoroTasks::Fail(COROTASKS_JOIN(CoroTryResult_, __LINE__).StealError()); \
+		auto Var = COROTASKS_JOIN(CoroTryResult_, __LINE__).StealValue()
+
+	#define CORO_TRY_VOID(Awaitable) \
+		do \
+		{ \
+			auto CoroTryResult = co_await (Awaitable); \
+			if (CoroTryResult.HasError()) \
+				co_await CoroTasks::Fail(CoroTryResult.StealError()); \
+		} while (false)
+
+#endif
@@ -0,0 +1,133 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CoroTasks::Core
+{
+	/**
+	 * Per thread free lists of coroutine frames bucketed by size.
+	 * AllocatorType provides static Malloc(Size) and Free(Ptr) for frames that don't fit the buckets.
+	 * Thread cache lives in the translation unit that instantiates the pool, so engine modules instantiate it once in a .cpp
+	 */
+	template<typename AllocatorType>
+	struct TFramePool
+	{
+		static constexpr std::size_t BucketGranularity = 64;
+		static constexpr int32_t NumBuckets = 32;
+		static constexpr int32_t MaxCachedPerBucket = 256;
+
+		static void* Allocate(std::size_t Size)
+		{
+			const int32_t Bucket = GetBucketIndex(Size);
+			if (Bucket >= NumBuckets)
+				return AllocatorType::Malloc(Size);
+
+			// Coroutines started by destructors of other thread locals bypass the destroyed cache.
+			// Frame still gets the bucket size, it may be freed into a live cache of another thread
+			if (!IsCacheDestroyed())
+			{
+				FThreadCache& Cache = GetThreadCache();
+				if (FFreeFrame* Frame = Cache.Buckets[Bucket])
+				{
+					Cache.Buckets[Bucket] = Frame->Next;
+					--Cache.NumCached[Bucket];
+					return Frame;
+				}
+			}
+			return AllocatorType::Malloc((Bucket + 1) * BucketGranularity);
+		}
+
+		static void Free(void* Ptr, std::size_t Size)
+		{
+			const int32_t Bucket = GetBucketIndex(Size);
+			if (Bucket >= NumBuckets || IsCacheDestroyed())
+			{
+				AllocatorType::Free(Ptr);
+				return;
+			}
+
+			FThreadCache& Cache = GetThreadCache();
+			if (Cache.NumCached[Bucket] >= MaxCachedPerBucket)
+			{
+				AllocatorType::Free(Ptr);
+				return;
+			}
+
+			FFreeFrame* Frame = static_cast<FFreeFrame*>(Ptr);
+			Frame->Next = Cache.Buckets[Bucket];
+			Cache.Buckets[Bucket] = Frame;
+			++Cache.NumCached[Bucket];
+		}
+
+	private:
+		struct FFreeFrame
+		{
+			FFreeFrame* Next;
+		};
+
+		struct FThreadCache
+		{
+			FFreeFrame* Buckets[NumBuckets] = {};
+			int32_t NumCached[NumBuckets] = {};
+
+			~FThreadCache()
+			{
+				IsCacheDestroyed() = true;
+				for (int32_t Bucket = 0; Bucket < NumBuckets; ++Bucket)
+				{
+					FFreeFrame* Frame = Buckets[Bucket];
+					while (Frame)
+					{
+						FFreeFrame* Next = Frame->Next;
+						AllocatorType::Free(Frame);
+						Frame = Next;
+					}
+					Buckets[Bucket] = nullptr;
+					NumCached[Bucket] = 0;
+				}
+			}
+		};
+
+		static FThreadCache& GetThreadCache()
+		{
+			thread_local FThreadCache Cache;
+			return Cache;
+		}
+
+		/** Trivially destructible, so it stays readable after the cache itself is destroyed */
+		static bool& IsCacheDestroyed()
+		{
+			thread_local bool bCacheDestroyed = false;
+			return bCacheDestroyed;
+		}
+
+		static int32_t GetBucketIndex(std::size_t Size)
+		{
+			return (int32_t)((Size - 1) / BucketGranularity);
+		}
+	};
+}
@@ -0,0 +1,289 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "CoroCoreConfig.h"
+
+namespace CoroTasks
+{
+	/**
+	 * Non-virtual and packed: futures are created for every latent operation.
+	 * Derived futures are always owned by their concrete type (TSharedRef keeps the real deleter), so no virtual destructor is needed
+	 */
+	struct [[nodiscard]] FFuture_Base
+	{
+	
+	public:
+		explicit FFuture_Base()
+			: CoroutineHandle(nullptr)
+			, bResultIsSet(false)
+			, bWasSuspended(false)
+			, bResumed(false)
+		{}
+
+		bool await_ready()
+		{
+			return bResultIsSet;
+		}
+
+		template<typename PromiseType>
+		void await_suspend(std::coroutine_handle<PromiseType> Continuation)
+		{
+			bWasSuspended = true;
+			CoroutineHandle = Continuation;
+			COROTASKS_TRACE(OnSuspend, Continuation.address(), COROTASKS_TEXT("TFuture"));
+			COROTASKS_REGISTRY(RegistryNode.OnAwaited(Continuation));
+		}
+
+		void Resume()
+		{
+			if COROTASKS_ENSURE(!bResumed, "Future already resumed")
+			{
+				bResumed = true;
+				COROTASKS_REGISTRY(RegistryNode.OnAwaitResumed());
+				if (!CoroutineHandle)
+					return;
+				COROTASKS_TRACE_RESUME_SCOPE(CoroutineHandle.address());
+				CoroutineHandle.resume();
+			}
+		}
+
+		bool IsResumed() const
+		{
+			return bResumed;
+		}
+
+		/** Awaiting frame is destroyed (cancelled) while suspended: result is still accepted, but nobody is resumed */
+		void Forget()
+		{
+			CoroutineHandle = nullptr;
+		}
+
+#if COROTASKS_WITH_EXCEPTIONS
+		void SetException(std::exception_ptr ExcPtr)
+		{
+			Exception = ExcPtr;
+			COROTASKS_REGISTRY(RegistryNode.SetState(ECoroRegistryState::Finished));
+			COROTASKS_REGISTRY(RegistryNode.OnAwaitResumed());
+			if (!CoroutineHandle)
+				return;
+			COROTASKS_TRACE_RESUME_SCOPE(CoroutineHandle.address());
+			CoroutineHandle.resume();
+		}
+
+		template<typename T>
+		void SetException(T&& Exception)
+		{
+			SetException(std::make_exception_ptr(std::move(Exception)));
+		}
+#endif
+
+#if COROTASKS_WITH_REGISTRY
+		FCoroRegistryNode RegistryNode{ECoroRegistryKind::Future};
+#endif
+
+	protected:
+
+		void ThrowIfException() const
+		{
+#if COROTASKS_WITH_EXCEPTIONS
+			if (Exception)
+				std::rethrow_exception(Exception);
+#endif
+		}
+	
+		std::coroutine_handle<> CoroutineHandle;
+#if COROTASKS_WITH_EXCEPTIONS
+		std::exception_ptr Exception;
+#endif
+
+		uint8_t bResultIsSet : 1;
+		uint8_t bWasSuspended : 1;
+		uint8_t bResumed : 1;
+	};
+
+
+
+	template<typename TReturnValue>
+	struct TFuture_Base : FFuture_Base
+	{
+		using Super = FFuture_Base;
+		
+		explicit TFuture_Base()
+			: FFuture_Base()
+		{}
+	
+		std::optional<TReturnValue> Result;
+	};
+
+	template<>
+	struct TFuture_Base<void> : FFuture_Base
+	{
+		using Super = FFuture_Base;
+		
+		explicit TFuture_Base()
+			: FFuture_Base()
+		{
+		}
+	};
+
+
+	template<typename FutureType>
+	struct TFutureAwaiter;
+
+	template<typename TReturnValue>
+	struct [[nodiscard]] TFuture : public TFuture_Base<TReturnValue>
+	{
+		using Super = TFuture_Base<TReturnValue>;
+		explicit TFuture()
+			: Super()
+		{
+		}
+
+		/** Every co_await goes through a frame-local awaiter, so a cancelled frame is never resumed by the future */
+		TFutureAwaiter<TFuture> operator co_await()
+		{
+			return TFutureAwaiter<TFuture>(*this);
+		}
+	
+
+		auto await_resume()
+		{		
+			return GetResult();
+		}
+
+		template<typename T = TReturnValue>
+			requires (!std::is_void_v<T>)
+		void SetResult(T&& InResult)
+		{
+			const bool bHasResult = Super::bResultIsSet; 
+			COROTASKS_CHECK(!bHasResult);
+			if (bHasResult)
+				return;
+			
+			SetResult_Internal<T>(std::forward<T>(InResult));
+			if (Super::Super::bWasSuspended)
+				Super::Resume();
+		}
+
+		template<typename T = TReturnValue>
+			requires std::is_void_v<T>
+		void SetResult()
+		{
+			const bool bHasResult = Super::bResultIsSet; 
+			COROTASKS_CHECK(!bHasResult);
+			if (bHasResult)
+				return;
+			
+			SetResult_Internal();
+			
+			if (Super::Super::bWasSuspended)
+				Super::Resume();
+		}
+	
+	protected:
+		auto GetResult()
+		{
+			Super::ThrowIfException();
+			if constexpr (std::is_void_v<TReturnValue>)
+			{
+				return;
+			} else
+			{
+				COROTASKS_CHECK(Super::Result.has_value());
+				return *Super::Result;
+			}
+		}
+
+		
+		template<typename T = TReturnValue>
+			requires std::is_void_v<T>
+		void SetResult_Internal()
+		{
+			Super::bResultIsSet = true;
+			COROTASKS_REGISTRY(this->RegistryNode.SetState(ECoroRegistryState::Finished));
+		}
+
+
+		template<typename T = TReturnValue>
+			requires (!std::is_void_v<T>)
+		void SetResult_Internal(T&& InResult)
+		{
+			Super::bResultIsSet = true;
+			COROTASKS_REGISTRY(this->RegistryNode.SetState(ECoroRegistryState::Finished));
+			Super::Result.emplace(std::forward<T>(InResult));
+		}
+	};
+
+	/** Lives in the awaiting frame: if the frame is destroyed while suspended, the future forgets it */
+	template<typename FutureType>
+	struct TFutureAwaiter
+	{
+		explicit TFutureAwaiter(FutureType& InFuture)
+			: Future(InFuture)
+			, bSuspended(false)
+		{}
+
+		TFutureAwaiter(const TFutureAwaiter&) = delete;
+		TFutureAwaiter& operator=(const TFutureAwaiter&) = delete;
+
+		~TFutureAwaiter()
+		{
+			if (bSuspended && !Future.IsResumed())
+				Future.Forget();
+		}
+
+		bool await_ready()
+		{
+			return Future.await_ready();
+		}
+
+		template<typename PromiseType>
+		void await_suspend(std::coroutine_handle<PromiseType> Continuation)
+		{
+			bSuspended = true;
+			Future.await_suspend(Continuation);
+		}
+
+		decltype(auto) await_resume()
+		{
+			return Future.await_resume();
+		}
+
+		FutureType& Future;
+		bool bSuspended;
+	};
+
+	/** Budgets are for builds without exceptions (the engine default), exception_ptr is paid on top of them */
+	constexpr std::size_t FutureExceptionSize = COROTASKS_WITH_EXCEPTIONS ? sizeof(void*) : 0;
+	static_assert(sizeof(TFuture<void>) <= 3 * sizeof(void*) + RegistryNodeSize, "TFuture<void> exceeds its size budget");
+	static_assert(sizeof(TFuture<int>) <= 4 * sizeof(void*) + RegistryNodeSize, "TFuture<int> exceeds its size budget");
+	static_assert(sizeof(TFuture<void*>) <= 4 * sizeof(void*) + FutureExceptionSize + RegistryNodeSize, "TFuture<void*> exceeds its size budget");
+}
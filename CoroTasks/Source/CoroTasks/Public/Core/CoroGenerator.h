@@ -0,0 +1,333 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <exception>
+#include <type_traits>
+
+#include "CoroCoreConfig.h"
+
+/**
+ * Tour to generators:
+ * TGenerator is a synchronous lazy sequence. The body runs only when the caller asks for the next element,
+ * so you can walk huge data without building intermediate arrays.
+ *	1. Elements are yielded by reference, nothing is copied
+ *	2. Nested generator can be yielded entirely with co_yield (recursive yield-from), resumption always goes
+ *		straight to the innermost generator
+ *	3. Frame is taken from the frame pool, so iteration itself doesn't allocate
+ *
+ * Use case:
+ * >>> CoroTasks::TGenerator<AActor&> ActorsWithTag(UWorld* World, FName Tag)
+ * >>> {
+ * >>>		for (TActorIterator<AActor> It(World); It; ++It)
+ * >>>			if (It->ActorHasTag(Tag))
+ * >>>				co_yield **It;
+ * >>> }
+ *
+ * >>> CoroTasks::TGenerator<const FNode&> Walk(const FNode& Node)
+ * >>> {
+ * >>>		co_yield Node;
+ * >>>		for (const FNode& Child : Node.Children)
+ * >>>			co_yield Walk(Child);
+ * >>> }
+ *
+ * >>> for (AActor& Actor : ActorsWithTag(World, TEXT("Enemy")))
+ * >>>		...
+ *
+ * Generators can't co_await, use TTask for asynchronous code
+ */
+namespace CoroTasks
+{
+	template<typename T>
+	class [[nodiscard]] TGenerator
+	{
+	public:
+		using ValueType = std::remove_reference_t<T>;
+		using ReferenceType = std::conditional_t<std::is_reference_v<T>, T, T&>;
+
+		struct promise_type;
+		using HandleType = std::coroutine_handle<promise_type>;
+
+		struct promise_type : FPooledFrame
+		{
+			promise_type()
+				: Value(nullptr)
+				, Root(this)
+				, Leaf(this)
+				, Parent(nullptr)
+			{}
+
+			TGenerator get_return_object()
+			{
+				return TGenerator(HandleType::from_promise(*this));
+			}
+
+			std::suspend_always initial_suspend() noexcept
+			{
+				return {};
+			}
+
+			struct FFinalAwaiter
+			{
+				bool await_ready() noexcept
+				{
+					return false;
+				}
+
+				/** Nested generator gives control back to the parent, root one returns to iterator */
+				std::coroutine_handle<> await_suspend(HandleType Handle) noexcept
+				{
+					promise_type& Promise = Handle.promise();
+					if (Promise.Parent)
+					{
+						Promise.Root->Leaf = Promise.Parent;
+						return HandleType::from_promise(*Promise.Parent);
+					}
+					return std::noop_coroutine();
+				}
+
+				void await_resume() noexcept
+				{
+				}
+			};
+
+			FFinalAwaiter final_suspend() noexcept
+			{
+				return {};
+			}
+
+			std::suspend_always yield_value(ValueType& InValue) noexcept
+			{
+				Value = std::addressof(InValue);
+				return {};
+			}
+
+			/** Temporary lives in the frame until generator is resumed, so pointer stays valid while caller looks at it */
+			std::suspend_always yield_value(ValueType&& InValue) noexcept
+			{
+				Value = std::addressof(InValue);
+				return {};
+			}
+
+			/** Holds the copy in the frame until generator is resumed */
+			struct FYieldCopyAwaiter
+			{
+				std::remove_cv_t<ValueType> Copy;
+
+				bool await_ready() noexcept
+				{
+					return false;
+				}
+
+				void await_suspend(HandleType Handle) noexcept
+				{
+					Handle.promise().Value = std::addressof(Copy);
+				}
+
+				void await_resume() noexcept
+				{
+				}
+			};
+
+			/** Const lvalue can't be handed out as mutable element, so it's copied */
+			template<typename U = ValueType> requires (!std::is_const_v<U>)
+			FYieldCopyAwaiter yield_value(const U& InValue)
+			{
+				return FYieldCopyAwaiter{InValue};
+			}
+
+			struct FYieldFromAwaiter
+			{
+				TGenerator& Nested;
+
+				bool await_ready() noexcept
+				{
+					return !Nested.Handle;
+				}
+
+				std::coroutine_handle<> await_suspend(HandleType Handle) noexcept
+				{
+					promise_type& Current = Handle.promise();
+					promise_type& NestedPromise = Nested.Handle.promise();
+					NestedPromise.Root = Current.Root;
+					NestedPromise.Parent = &Current;
+					Current.Root->Leaf = &NestedPromise;
+					return Nested.Handle;
+				}
+
+				void await_resume()
+				{
+					if (Nested.Handle)
+						Nested.Handle.promise().RethrowIfException();
+				}
+			};
+
+			FYieldFromAwaiter yield_value(TGenerator&& Nested) noexcept
+			{
+				return FYieldFromAwaiter{Nested};
+			}
+
+			FYieldFromAwaiter yield_value(TGenerator& Nested) noexcept
+			{
+				return FYieldFromAwaiter{Nested};
+			}
+
+			void return_void()
+			{
+			}
+
+#if COROTASKS_WITH_EXCEPTIONS
+			void unhandled_exception()
+			{
+				Exception = std::current_exception();
+			}
+
+			void RethrowIfException() const
+			{
+				if (Exception)
+					std::rethrow_exception(Exception);
+			}
+#else
+			void unhandled_exception()
+			{
+				COROTASKS_CHECK(false);
+			}
+
+			void RethrowIfException() const
+			{
+			}
+#endif
+
+			template<typename U>
+			std::suspend_never await_transform(U&&) = delete;
+
+			ValueType* Value;
+			promise_type* Root;
+			promise_type* Leaf;
+			promise_type* Parent;
+#if COROTASKS_WITH_EXCEPTIONS
+			std::exception_ptr Exception;
+#endif
+		};
+
+		struct FSentinel
+		{
+		};
+
+		class FIterator
+		{
+		public:
+			explicit FIterator(HandleType InHandle)
+				: Handle(InHandle)
+			{}
+
+			FIterator& operator++()
+			{
+				Advance(Handle);
+				return *this;
+			}
+
+			ReferenceType operator*() const
+			{
+				return static_cast<ReferenceType>(*Handle.promise().Leaf->Value);
+			}
+
+			ValueType* operator->() const
+			{
+				return Handle.promise().Leaf->Value;
+			}
+
+			bool operator==(FSentinel) const
+			{
+				return !Handle || Handle.done();
+			}
+
+			bool operator!=(FSentinel Sentinel) const
+			{
+				return !(*this == Sentinel);
+			}
+
+		private:
+			HandleType Handle;
+		};
+
+		TGenerator()
+			: Handle(nullptr)
+		{}
+
+		TGenerator(TGenerator&& Other)
+			: Handle(Other.Handle)
+		{
+			Other.Handle = nullptr;
+		}
+
+		TGenerator& operator=(TGenerator&& Other)
+		{
+			if (this != &Other)
+			{
+				if (Handle)
+					Handle.destroy();
+				Handle = Other.Handle;
+				Other.Handle = nullptr;
+			}
+			return *this;
+		}
+
+		TGenerator(const TGenerator&) = delete;
+		TGenerator& operator=(const TGenerator&) = delete;
+
+		~TGenerator()
+		{
+			if (Handle)
+				Handle.destroy();
+		}
+
+		/** Runs generator up to the first element. Generator can be iterated only once */
+		FIterator begin()
+		{
+			if (Handle)
+				Advance(Handle);
+			return FIterator(Handle);
+		}
+
+		FSentinel end()
+		{
+			return {};
+		}
+
+	private:
+		explicit TGenerator(HandleType InHandle)
+			: Handle(InHandle)
+		{}
+
+		static void Advance(HandleType Root)
+		{
+			HandleType::from_promise(*Root.promise().Leaf).resume();
+			if (Root.done())
+				Root.promise().RethrowIfException();
+		}
+
+		HandleType Handle;
+	};
+}
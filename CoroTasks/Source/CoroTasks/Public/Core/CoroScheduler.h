@@ -0,0 +1,153 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "CoroCoreConfig.h"
+
+/**
+ * Tour to resumption:
+ * Every awaitable that resumes a coroutine from "outside" (primitives, channels, worker thread jobs)
+ * should do it through FContinuation. It remembers the thread where coroutine was suspended,
+ * so the game thread coroutine will never continue on a worker thread (adapter decides what the main thread is)
+ *	>>> FContinuation Continuation = FContinuation::Capture(Handle, COROTASKS_TEXT("FMyAwaitable"));	// in await_suspend
+ *	>>> ...
+ *	>>> Continuation.Resume();		// from any thread
+ *
+ * Resumes queued to the game thread are dropped when the frame is destroyed (cancelled) before they run.
+ * Completions that can't be unsubscribed (engine tasks, futures, worker jobs) resume through FRevocableContinuation
+ * shared with the awaiter, which revokes it in its destructor
+ */
+namespace CoroTasks
+{
+	struct FContinuation
+	{
+		FContinuation()
+			: Handle(nullptr)
+			, bGameThread(false)
+		{}
+
+		/** AwaitableType is a literal shown in trace for this suspension */
+		static FContinuation Capture(std::coroutine_handle<> InHandle, [[maybe_unused]] Core::FAwaitableName AwaitableType)
+		{
+			COROTASKS_TRACE(OnSuspend, InHandle.address(), AwaitableType);
+			COROTASKS_REGISTRY(FCoroRegistry::OnContinuationCaptured());
+			FContinuation Continuation;
+			Continuation.Handle = InHandle;
+			Continuation.bGameThread = Core::IsInMainThread();
+			return Continuation;
+		}
+
+		bool IsValid() const
+		{
+			return (bool)Handle;
+		}
+
+		/** Resume from the current thread has to be queued to the game thread */
+		bool NeedsDispatch() const
+		{
+			return bGameThread && !Core::IsInMainThread();
+		}
+
+		/** Resumes inline when possible, otherwise dispatches the resume to the game thread */
+		void Resume() const
+		{
+			COROTASKS_CHECK(Handle);
+			COROTASKS_REGISTRY(FCoroRegistry::OnContinuationResumed());
+			if (NeedsDispatch())
+			{
+				Core::ResumeOnMainThread(Handle);
+			}
+			else
+			{
+				COROTASKS_TRACE_RESUME_SCOPE(Handle.address());
+				Handle.resume();
+			}
+		}
+
+		std::coroutine_handle<> Handle;
+		bool bGameThread;
+	};
+
+	/**
+	 * Continuation shared by an awaiter and a completion that may come after the awaiter is destroyed.
+	 * The first of Resume and Revoke wins. Revoke waits while a concurrent Resume queues the game thread resume,
+	 * so the queued resume exists before the destroyed frame drops its queued resumes.
+	 * Coroutine that was suspended on a worker thread is resumed inline, it shouldn't be destroyed from another thread
+	 */
+	class FRevocableContinuation
+	{
+	public:
+		explicit FRevocableContinuation(const FContinuation& InContinuation)
+			: Continuation(InContinuation)
+			, State(EState::Waiting)
+		{}
+
+		FRevocableContinuation(const FRevocableContinuation&) = delete;
+		FRevocableContinuation& operator=(const FRevocableContinuation&) = delete;
+
+		/** From any thread, does nothing after Revoke */
+		void Resume()
+		{
+			EState Expected = EState::Waiting;
+			if (!State.compare_exchange_strong(Expected, EState::Resuming))
+				return;
+
+			if (Continuation.NeedsDispatch())
+			{
+				Continuation.Resume();
+				State.store(EState::Done);
+			}
+			else
+			{
+				// The awaiter may be destroyed by the resumed coroutine
+				State.store(EState::Done);
+				Continuation.Resume();
+			}
+		}
+
+		/** From the destructor of the awaiter */
+		void Revoke()
+		{
+			EState Expected = EState::Waiting;
+			if (State.compare_exchange_strong(Expected, EState::Done))
+				return;
+			while (State.load() == EState::Resuming)
+				std::this_thread::yield();
+		}
+
+	private:
+		enum class EState : uint8_t
+		{
+			Waiting,
+			Resuming,
+			Done
+		};
+
+		FContinuation Continuation;
+		std::atomic<EState> State;
+	};
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "CoroSupport.h"
+#include "CoroFramePoolCore.h"
+
+/** Engine-independent adapter (see CoroCoreConfig.h) */
+
+/** Active in every build type, like check() in non-shipping engine builds */
+#define COROTASKS_CHECK(Expr) ((Expr) ? (void)0 : CoroTasks::Core::ReportCheck(#Expr, __FILE__, __LINE__))
+#define COROTASKS_ENSURE(Expr, Message) ((Expr) || (CoroTasks::Core::ReportEnsure(#Expr, Message), false))
+#define COROTASKS_TEXT(Literal) Literal
+
+#define COROTASKS_TRACE(Event, ...)
+#define COROTASKS_TRACE_RESUME_SCOPE(Task)
+#define COROTASKS_REGISTRY(...)
+
+#ifndef COROTASKS_WITH_REGISTRY
+	#define COROTASKS_WITH_REGISTRY 0
+#endif
+#ifndef COROTASKS_WITH_AWAIT_LATENCY
+	#define COROTASKS_WITH_AWAIT_LATENCY 0
+#endif
+
+static_assert(!COROTASKS_WITH_REGISTRY && !COROTASKS_WITH_AWAIT_LATENCY, "Registry and await latency need the engine");
+
+namespace CoroTasks
+{
+	namespace Core
+	{
+		using FAwaitableName = const char*;
+
+		inline void ReportEnsure(const char* Expression, const char* Message)
+		{
+			std::fprintf(stderr, "Ensure condition failed: %s (%s)\n", Expression, Message);
+		}
+
+		[[noreturn]] inline void ReportCheck(const char* Expression, const char* File, int Line)
+		{
+			std::fprintf(stderr, "Check failed: %s [%s:%d]\n", Expression, File, Line);
+			std::abort();
+		}
+
+		/** There is no main thread dispatcher outside of the engine, continuations are resumed inline */
+		inline bool IsInMainThread()
+		{
+			return false;
+		}
+
+		inline void ResumeOnMainThread(std::coroutine_handle<> Handle)
+		{
+			Handle.resume();
+		}
+
+		inline void ForgetMainThreadResumes(void*)
+		{
+		}
+
+		struct FMallocFrameAllocator
+		{
+			static void* Malloc(std::size_t Size)
+			{
+				return std::malloc(Size);
+			}
+
+			static void Free(void* Ptr)
+			{
+				std::free(Ptr);
+			}
+		};
+	}
+
+	struct FCoroError
+	{
+		explicit FCoroError(std::string InMessage)
+			: Message(std::move(InMessage))
+		{}
+
+		const std::string& GetMessage() const
+		{
+			return Message;
+		}
+
+	protected:
+		std::string Message;
+	};
+
+	struct FPooledFrame
+	{
+		static void* operator new(std::size_t Size)
+		{
+			return Core::TFramePool<Core::FMallocFrameAllocator>::Allocate(Size);
+		}
+
+		static void operator delete(void* Ptr, std::size_t Size)
+		{
+			Core::TFramePool<Core::FMallocFrameAllocator>::Free(Ptr, Size);
+		}
+	};
+
+	constexpr std::size_t RegistryNodeSize = 0;
+}
@@ -32,5 +32,18 @@
 	    using std::experimental::coroutine_handle;
 	    using std::experimental::suspend_always;
 	    using std::experimental::suspend_never;
+	    using std::experimental::noop_coroutine;
 	}
 #endif
+
+/**
+ * Tasks propagate errors through C++ exceptions when they are enabled.
+ * Without exceptions errors travel through FCoroError and TCoroResult (see CoroError.h)
+ */
+#ifndef COROTASKS_WITH_EXCEPTIONS
+	#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+		#define COROTASKS_WITH_EXCEPTIONS 1
+	#else
+		#define COROTASKS_WITH_EXCEPTIONS 0
+	#endif
+#endif
@@ -0,0 +1,463 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "CoroCoreConfig.h"
+#include "CoroError.h"
+
+
+/**
+ * Common tour to async tasks
+ * You can create own async task. It is simple and very same to creation of function
+ * 
+ * For example:
+ * >>> TTask<bool> IsFerrariCar(TSoftObjectPtr<UCar> CarAsset)
+ * >>> {
+ * >>>		UCar* Car = co_await CoroTasks::LoadSingleObject(CarAsset);
+ * >>>		if (!Car)
+ * >>>          throw FCarIsNullException("Car asset is null!");
+ * >>>		co_return Car->IsA<UFerrariCar>();
+ * >>> }
+ *
+ * You can also await your other tasks to get a result:
+ * >>> TTask<FString> GetSpecialOrderMessage(TSoftObjectPtr<UCar> CarAsset)
+ * >>> {
+ * >>>		...
+ * >>>		bool bIsFerrari = co_await IsFerrariCar(CarAsset);
+ * >>>		if (bIsFerrari)
+ * >>>			co_return TEXT("There is discount for this car model");
+ * >>>		...
+ * >>> }
+ *
+ * You can even throw and catch exceptions that raised in async code
+ * >>> CoroTasks::TTask<TTuple<int32, FString>> GetPriceAndMessage(TSoftObjectPtr<UCar> CarAsset)
+ * >>> {
+ * >>>		try
+ * >>>		{
+ * >>>			FString SpecialOrderMessage = co_await GetSpecialOrderMessage(CarAsset);
+ * >>>			int32 Price = co_await GetPriceOf(CarAsset);
+ * >>>		} catch (FCarSellError& Error)
+ * >>>		{
+ * >>>			UE_LOG(LogCar, Fatal, TEXT("Internal sell error"), *Error.ToString());
+ * >>>		}
+ * >>>		co_return {Price, SpecialOrderMessage};
+ * >>> }
+ * If exceptions are disabled, errors are passed explicitly (see CoroError.h)
+ *
+ * You can use tuple structured binding. It is looks very powerful
+ * >>> CoroTasks::TTask<> BuyCar(TSoftObjectPtr<UCar> CarAsset)
+ * >>> {
+ * >>>		auto [Price, Message] = co_await GetPriceAndMessage(CarAsset);
+ * >>>		...
+ * >>> }
+ *
+ * To launch the in sync code, you can just call Launch method
+ * >>> void LaunchCarBuy(TSoftObjectPtr<UCar> CarAsset)
+ * >>> {
+ * >>>		auto Task = BuyCar();
+ * >>>		Task.Launch();
+ * >>> }
+ */
+namespace CoroTasks
+{
+	/**
+	 * State shared by all task promises. It's intentionally non-virtual and packed:
+	 * the promise lives inside of every coroutine frame
+	 */
+	struct FPromise_Base : FPooledFrame
+	{
+		FPromise_Base()
+			: Continuation(nullptr)
+			, bStarted(false)
+			, bFinished(false)
+			, bDetached(false)
+		{}
+
+		std::suspend_always initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		/** Frame is kept alive after the end, result is taken from the promise by owning TTask */
+		struct FFinalAwaiter
+		{
+			bool await_ready() noexcept
+			{
+				return false;
+			}
+
+			template<typename PromiseType>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<PromiseType> Handle) noexcept
+			{
+				return Handle.promise().Finish(Handle);
+			}
+
+			void await_resume() noexcept
+			{
+			}
+		};
+
+		FFinalAwaiter final_suspend() noexcept
+		{
+			return {};
+		}
+
+#if COROTASKS_WITH_AWAIT_LATENCY
+		/** Location of the default argument is the co_await expression itself */
+		template<typename AwaitableType>
+		auto await_transform(AwaitableType&& Awaitable, std::source_location Location = std::source_location::current())
+		{
+			return Private::MakeTimedAwaiter(std::forward<AwaitableType>(Awaitable), Location);
+		}
+#endif
+
+		/** Returns coroutine that should continue. Detached frame has no owner, so it destroys itself */
+		std::coroutine_handle<> Finish(std::coroutine_handle<> Handle) noexcept
+		{
+			bFinished = true;
+			COROTASKS_TRACE(OnComplete, Handle.address());
+			COROTASKS_REGISTRY(RegistryNode.SetState(ECoroRegistryState::Finished));
+			if (Continuation)
+			{
+				COROTASKS_REGISTRY(RegistryNode.OnAwaitResumed());
+				COROTASKS_TRACE(OnResume, Continuation.address());
+				return Continuation;
+			}
+			if (bDetached)
+			{
+				COROTASKS_ENSURE(!HasError(), "Detached task finished with unhandled error");
+				COROTASKS_TRACE(OnDestroy, Handle.address());
+				Handle.destroy();
+			}
+			return std::noop_coroutine();
+		}
+
+#if COROTASKS_WITH_EXCEPTIONS
+		void unhandled_exception()
+		{
+			Exception = std::current_exception();
+		}
+
+		bool HasError() const
+		{
+			return (bool)Exception;
+		}
+
+		void RethrowIfError()
+		{
+			if (Exception)
+				std::rethrow_exception(std::exchange(Exception, nullptr));
+		}
+#else
+		void unhandled_exception()
+		{
+			COROTASKS_CHECK(false);
+		}
+
+		bool HasError() const
+		{
+			return (bool)Error;
+		}
+
+		/** Finishes coroutine with error (see CORO_FAIL). Coroutine stays suspended at the failure point */
+		std::coroutine_handle<> Fail(std::coroutine_handle<> Handle, FCoroError&& InError) noexcept
+		{
+			Error = std::make_unique<FCoroError>(std::move(InError));
+			return Finish(Handle);
+		}
+
+		FCoroError StealError()
+		{
+			FCoroError Result = std::move(*Error);
+			Error.reset();
+			return Result;
+		}
+#endif
+
+		std::coroutine_handle<> Continuation;
+
+#if COROTASKS_WITH_EXCEPTIONS
+		std::exception_ptr Exception;
+#else
+		/** Errors are rare, so they are boxed to keep frames small */
+		std::unique_ptr<FCoroError> Error;
+#endif
+
+		uint8_t bStarted : 1;
+		uint8_t bFinished : 1;
+		uint8_t bDetached : 1;
+
+#if COROTASKS_WITH_REGISTRY
+		FCoroRegistryNode RegistryNode{ECoroRegistryKind::Task};
+#endif
+	};
+
+	/**
+	 * The templated base of promise with return value (general case)
+	 * Holds the result until owning task takes it
+	 */
+	template<
+		typename ReturnType,
+		typename TaskType
+	>
+	struct TPromise_Return : FPromise_Base
+	{
+		void return_value(ReturnType&& InResult)
+		{
+			Result.emplace(std::move(InResult));
+		}
+
+		void return_value(const ReturnType& InResult)
+		{
+			Result.emplace(InResult);
+		}
+
+		ReturnType StealResult()
+		{
+			COROTASKS_CHECK(Result.has_value());
+			return std::move(*Result);
+		}
+
+		std::optional<ReturnType> Result;
+	};
+
+	template<typename TaskType>
+	struct TPromise_Return<void, TaskType> : FPromise_Base
+	{
+		void return_void()
+		{
+		}
+
+		void StealResult()
+		{
+		}
+	};
+
+	/**
+	 * General promise
+	 */
+	template<typename ReturnType, typename TaskType>
+	struct TPromise : TPromise_Return<ReturnType, TaskType>
+	{
+		/** Frame destroyed while suspended (cancelled) drops resumes that are queued for it */
+		~TPromise()
+		{
+			if (this->bStarted && !this->bFinished)
+				Core::ForgetMainThreadResumes(TaskType::HandleType::from_promise(*this).address());
+		}
+
+		TaskType get_return_object()
+		{
+			auto Handle = TaskType::HandleType::from_promise(*this);
+			COROTASKS_TRACE(OnCreate, Handle.address());
+			COROTASKS_REGISTRY(this->RegistryNode.OnTaskCreated(Handle.address()));
+			return TaskType(Handle);
+		}
+	};
+
+	/**
+	 * Task owns the coroutine frame and is the awaiter of it at the same time.
+	 * It's just a handle: if task is destroyed while coroutine is still running, the coroutine is detached
+	 * and destroys its frame itself when finished. Cancel destroys the suspended coroutine instead
+	 */
+	template<typename R = void>
+	class [[nodiscard]] TTask
+	{
+	public:
+		using ReturnType = R;
+		using promise_type = TPromise<ReturnType, TTask<R>>;
+		using HandleType = std::coroutine_handle<promise_type>;
+#if COROTASKS_WITH_EXCEPTIONS
+		using AwaitResultType = R;
+#else
+		using AwaitResultType = TCoroResult<R>;
+#endif
+
+		TTask()
+			: Handle(nullptr)
+		{}
+
+		explicit TTask(HandleType InHandle)
+			: Handle(InHandle)
+		{}
+
+		TTask(TTask&& Other)
+			: Handle(Other.Handle)
+		{
+			Other.Handle = nullptr;
+		}
+
+		TTask& operator=(TTask&& Other)
+		{
+			if (this != &Other)
+			{
+				Release();
+				Handle = Other.Handle;
+				Other.Handle = nullptr;
+			}
+			return *this;
+		}
+
+		TTask(const TTask&) = delete;
+		TTask& operator=(const TTask&) = delete;
+
+		~TTask()
+		{
+			Release();
+		}
+
+		bool IsValid() const
+		{
+			return (bool)Handle;
+		}
+
+		bool IsDone() const
+		{
+			return Handle && Handle.promise().bFinished;
+		}
+
+		bool await_ready() const
+		{
+			return IsDone();
+		}
+
+		/**
+		 * Not started task is started right here with symmetric transfer, so deep await chains don't grow the stack.
+		 * That relies on the compiler turning the transfer into a tail call, which unoptimized GCC and MSVC builds don't do:
+		 * there every awaited task of a chain still takes a few stack frames
+		 */
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> Continuation)
+		{
+			auto& Promise = Handle.promise();
+			Promise.Continuation = Continuation;
+			COROTASKS_TRACE(OnSuspend, Continuation.address(), COROTASKS_TEXT("TTask"));
+			COROTASKS_REGISTRY(Promise.RegistryNode.OnAwaited(Continuation));
+			if (!Promise.bStarted)
+			{
+				Promise.bStarted = true;
+				COROTASKS_REGISTRY(Promise.RegistryNode.SetState(ECoroRegistryState::Started));
+				COROTASKS_TRACE(OnResume, Handle.address());
+				return Handle;
+			}
+			return std::noop_coroutine();
+		}
+
+		AwaitResultType await_resume()
+		{
+			auto& Promise = Handle.promise();
+#if COROTASKS_WITH_EXCEPTIONS
+			Promise.RethrowIfError();
+			return Promise.StealResult();
+#else
+			if (Promise.HasError())
+				return AwaitResultType(Promise.StealError());
+			if constexpr (std::is_void_v<R>)
+				return AwaitResultType();
+			else
+				return AwaitResultType(Promise.StealResult());
+#endif
+		}
+
+		/**
+		 * Destroys suspended coroutine with its locals, awaiters of the library are safe to destroy at any suspension point:
+		 * the task it awaits is cancelled too, awaited futures (delays, latent actions) forget the frame, game thread listeners
+		 * (delegates, ability system, traces...) unbind themselves, channel and sync primitive waiters leave their queues,
+		 * completions of engine tasks and futures are revoked, parallel loops wait for their batches in flight
+		 * and resumes already queued to the game thread are dropped.
+		 * Nobody is resumed: cancel only tasks owned by sync code (not awaited ones), never from inside of the coroutine itself,
+		 * and never from another thread while the coroutine waits on a worker thread (completions resume it inline there)
+		 */
+		void Cancel()
+		{
+			if (!Handle)
+				return;
+
+			auto& Promise = Handle.promise();
+			if (Promise.bStarted && !Promise.bFinished)
+			{
+				COROTASKS_TRACE(OnDestroy, Handle.address());
+				Handle.destroy();
+				Handle = nullptr;
+			}
+			else
+			{
+				Release();
+			}
+		}
+
+		bool Launch()
+		{
+			COROTASKS_CHECK(Handle != nullptr);
+			auto& Promise = Handle.promise();
+			if COROTASKS_ENSURE(!Promise.bStarted, "Task already launched")
+			{
+				Promise.bStarted = true;
+				COROTASKS_REGISTRY(Promise.RegistryNode.SetState(ECoroRegistryState::Started));
+				COROTASKS_TRACE(OnLaunch, Handle.address());
+				COROTASKS_TRACE_RESUME_SCOPE(Handle.address());
+				Handle.resume();
+			}
+			return true;
+		}
+
+	protected:
+		void Release()
+		{
+			if (!Handle)
+				return;
+
+			auto& Promise = Handle.promise();
+			if (!Promise.bStarted || Promise.bFinished)
+			{
+				COROTASKS_ENSURE(!Promise.HasError(), "Task finished with unhandled error");
+				COROTASKS_TRACE(OnDestroy, Handle.address());
+				Handle.destroy();
+			}
+			else if (Promise.Continuation)
+			{
+				// Awaiting frame is destroyed while it waits for us, it happens only when that frame is cancelled
+				COROTASKS_TRACE(OnDestroy, Handle.address());
+				Handle.destroy();
+			}
+			else
+			{
+				Promise.bDetached = true;
+			}
+			Handle = nullptr;
+		}
+
+		HandleType Handle;
+	};
+
+	static_assert(sizeof(TTask<int>) == sizeof(void*), "TTask should be a single coroutine handle");
+	static_assert(sizeof(TPromise<void, TTask<void>>) <= 3 * sizeof(void*) + RegistryNodeSize, "Promise of TTask<void> exceeds its size budget");
+	static_assert(sizeof(TPromise<int, TTask<int>>) <= 4 * sizeof(void*) + RegistryNodeSize, "Promise of TTask<int> exceeds its size budget");
+	static_assert(sizeof(TPromise<bool, TTask<bool>>) <= 4 * sizeof(void*) + RegistryNodeSize, "Promise of TTask<bool> exceeds its size budget");
+}
@@ -0,0 +1,279 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroAwaitLatency.h"
+
+#if COROTASKS_WITH_AWAIT_LATENCY
+
+#include "CoroTasks.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+using namespace CoroTasks;
+
+bool FAwaitLatency::bEnabled = false;
+
+namespace
+{
+	struct FAwaitSiteKey
+	{
+		const char* File;
+		uint32 Line;
+		uint32 Column;
+		const TCHAR* AwaitableType;
+
+		bool operator==(const FAwaitSiteKey& Other) const
+		{
+			return File == Other.File && Line == Other.Line && Column == Other.Column && AwaitableType == Other.AwaitableType;
+		}
+
+		friend uint32 GetTypeHash(const FAwaitSiteKey& Key)
+		{
+			return HashCombine(HashCombine(PointerHash(Key.File), Key.Line * 31 + Key.Column), PointerHash(Key.AwaitableType));
+		}
+	};
+
+	FRWLock SitesLock;
+	TMap<FAwaitSiteKey, TUniquePtr<FAwaitSite>> Sites;
+
+	FAutoConsoleVariableRef CVarTrackAwaitLatency(
+		TEXT("CoroTasks.TrackAwaitLatency"),
+		FAwaitLatency::bEnabled,
+		TEXT("Aggregates suspend-to-resume latency of every co_await in tasks per call site"));
+
+	FAutoConsoleCommand AwaitLatencyReportCommand(
+		TEXT("CoroTasks.AwaitLatencyReport"),
+		TEXT("Prints co_await sites with the largest total latency. Optional argument is count of printed sites (20 by default)"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([] (const TArray<FString>& Args)
+		{
+			FAwaitLatency::DumpReport(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 20);
+		}));
+
+	FAutoConsoleCommand AwaitLatencyCsvCommand(
+		TEXT("CoroTasks.AwaitLatencyCsv"),
+		TEXT("Exports co_await latency histograms to CSV. Optional argument is file name"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([] (const TArray<FString>& Args)
+		{
+			const FString FileName = Args.Num() > 0
+				? Args[0]
+				: FPaths::ProfilingDir() / TEXT("CSV") / FString::Printf(TEXT("AwaitLatency_%s.csv"), *FDateTime::Now().ToString());
+			if (FAwaitLatency::ExportCsv(FileName))
+				UE_LOG(LogCoroTasks, Display, TEXT("Await latency is written to %s"), *FileName);
+		}));
+
+	FAutoConsoleCommand AwaitLatencyResetCommand(
+		TEXT("CoroTasks.AwaitLatencyReset"),
+		TEXT("Clears collected co_await latency"),
+		FConsoleCommandDelegate::CreateStatic(&FAwaitLatency::Reset));
+
+#if CSV_PROFILER
+	/** Captures of csvprofile get their own await latency file */
+	FDelayedAutoRegisterHelper CsvCaptureListener(EDelayedRegisterRunPhase::EndOfEngineInit, []
+	{
+		FCsvProfiler::Get()->OnCSVProfileStart().AddLambda([]
+		{
+			if (FAwaitLatency::bEnabled)
+				FAwaitLatency::Reset();
+		});
+		FCsvProfiler::Get()->OnCSVProfileFinished().AddLambda([] (const FString& CaptureFileName)
+		{
+			if (FAwaitLatency::bEnabled)
+				FAwaitLatency::ExportCsv(FPaths::GetBaseFilename(CaptureFileName, false) + TEXT("_AwaitLatency.csv"));
+		});
+	});
+#endif
+
+	double CyclesToMs(uint64 Cycles)
+	{
+		return FPlatformTime::ToMilliseconds64(Cycles);
+	}
+
+	/** Upper bound of the bucket that contains the percentile */
+	double GetPercentileMs(const FAwaitSite& Site, double Percentile)
+	{
+		const uint64 NumSuspended = Site.NumSuspended.load(std::memory_order_relaxed);
+		const uint64 Threshold = FMath::Max<uint64>(1, (uint64)FMath::CeilToDouble(NumSuspended * Percentile));
+		uint64 Accumulated = 0;
+		for (int32 Bucket = 0; Bucket < FAwaitSite::NumBuckets; ++Bucket)
+		{
+			Accumulated += Site.Buckets[Bucket].load(std::memory_order_relaxed);
+			if (Accumulated >= Threshold)
+				return (double)(1ull << Bucket) / 1000.0;
+		}
+		return CyclesToMs(Site.MaxCycles.load(std::memory_order_relaxed));
+	}
+
+	FString GetSiteName(const FAwaitSite& Site)
+	{
+		return FString::Printf(TEXT("%s:%u"), *FPaths::GetCleanFilename(ANSI_TO_TCHAR(Site.Location.file_name())), Site.Location.line());
+	}
+
+	TArray<const FAwaitSite*> GetSortedSites()
+	{
+		TArray<const FAwaitSite*> Result;
+		{
+			FReadScopeLock Lock(SitesLock);
+			for (const auto& Pair : Sites)
+				Result.Add(Pair.Value.Get());
+		}
+		Result.Sort([] (const FAwaitSite& A, const FAwaitSite& B)
+		{
+			return A.TotalCycles.load(std::memory_order_relaxed) > B.TotalCycles.load(std::memory_order_relaxed);
+		});
+		return Result;
+	}
+}
+
+FString Private::ExtractTypeName(const TCHAR* FunctionSignature)
+{
+	FString Signature = FunctionSignature;
+	FString Name;
+	// "GetTypeName() [with T = Type; ...]" or "GetTypeName() [T = Type]"
+	int32 Start = Signature.Find(TEXT("T = "));
+	if (Start != INDEX_NONE)
+	{
+		Start += 4;
+		int32 End = Signature.Find(TEXT(";"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Start);
+		if (End == INDEX_NONE)
+			End = Signature.Find(TEXT("]"), ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+		Name = Signature.Mid(Start, End - Start);
+	}
+	// "GetTypeName<class Type>(void)"
+	else if ((Start = Signature.Find(TEXT("GetTypeName<"))) != INDEX_NONE)
+	{
+		Start += 12;
+		const int32 End = Signature.Find(TEXT(">(void)"), ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+		Name = Signature.Mid(Start, End - Start);
+	}
+	else
+	{
+		Name = MoveTemp(Signature);
+	}
+	Name.ReplaceInline(TEXT("class "), TEXT(""), ESearchCase::CaseSensitive);
+	Name.ReplaceInline(TEXT("struct "), TEXT(""), ESearchCase::CaseSensitive);
+	return Name;
+}
+
+FAwaitSite& FAwaitLatency::FindOrAddSite(const std::source_location& Location, const TCHAR* AwaitableType)
+{
+	const FAwaitSiteKey Key{Location.file_name(), Location.line(), Location.column(), AwaitableType};
+	{
+		FReadScopeLock Lock(SitesLock);
+		if (const TUniquePtr<FAwaitSite>* Site = Sites.Find(Key))
+			return **Site;
+	}
+
+	FWriteScopeLock Lock(SitesLock);
+	TUniquePtr<FAwaitSite>& Site = Sites.FindOrAdd(Key);
+	if (!Site.IsValid())
+	{
+		Site = MakeUnique<FAwaitSite>();
+		Site->Location = Location;
+		Site->AwaitableType = AwaitableType;
+	}
+	return *Site;
+}
+
+void FAwaitLatency::RecordReady(const std::source_location& Location, const TCHAR* AwaitableType)
+{
+	FindOrAddSite(Location, AwaitableType).NumReady.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FAwaitLatency::RecordResume(const std::source_location& Location, const TCHAR* AwaitableType, uint64 SuspendedCycles)
+{
+	FAwaitSite& Site = FindOrAddSite(Location, AwaitableType);
+	const uint64 Microseconds = (uint64)(FPlatformTime::ToMilliseconds64(SuspendedCycles) * 1000.0);
+	Site.NumSuspended.fetch_add(1, std::memory_order_relaxed);
+	Site.TotalCycles.fetch_add(SuspendedCycles, std::memory_order_relaxed);
+	Site.Buckets[FAwaitSite::GetBucket(Microseconds)].fetch_add(1, std::memory_order_relaxed);
+
+	uint64 MaxCycles = Site.MaxCycles.load(std::memory_order_relaxed);
+	while (SuspendedCycles > MaxCycles && !Site.MaxCycles.compare_exchange_weak(MaxCycles, SuspendedCycles, std::memory_order_relaxed))
+	{
+	}
+}
+
+void FAwaitLatency::DumpReport(int32 Count)
+{
+	const TArray<const FAwaitSite*> SortedSites = GetSortedSites();
+	UE_LOG(LogCoroTasks, Display, TEXT("co_await sites (%d tracked), sorted by total latency:"), SortedSites.Num());
+	UE_LOG(LogCoroTasks, Display, TEXT("%10s %10s %10s %10s %10s %10s  %s"),
+		TEXT("Suspended"), TEXT("Ready"), TEXT("Total ms"), TEXT("p50 ms"), TEXT("p99 ms"), TEXT("Max ms"), TEXT("Site"));
+	for (int32 Index = 0; Index < FMath::Min(Count, SortedSites.Num()); ++Index)
+	{
+		const FAwaitSite& Site = *SortedSites[Index];
+		UE_LOG(LogCoroTasks, Display, TEXT("%10llu %10llu %10.2f %10.3f %10.3f %10.2f  %s %s in %s"),
+			Site.NumSuspended.load(), Site.NumReady.load(), CyclesToMs(Site.TotalCycles.load()),
+			GetPercentileMs(Site, 0.5), GetPercentileMs(Site, 0.99), CyclesToMs(Site.MaxCycles.load()),
+			*GetSiteName(Site), Site.AwaitableType, ANSI_TO_TCHAR(Site.Location.function_name()));
+	}
+}
+
+bool FAwaitLatency::ExportCsv(const FString& FileName)
+{
+	FString Csv = TEXT("File,Line,Function,Awaitable,Suspended,Ready,TotalMs,P50Ms,P99Ms,MaxMs");
+	for (int32 Bucket = 0; Bucket < FAwaitSite::NumBuckets; ++Bucket)
+		Csv += FString::Printf(TEXT(",Below%lluus"), 1ull << Bucket);
+	Csv += LINE_TERMINATOR;
+
+	for (const FAwaitSite* Site : GetSortedSites())
+	{
+		Csv += FString::Printf(TEXT("\"%s\",%u,\"%s\",\"%s\",%llu,%llu,%.3f,%.3f,%.3f,%.3f"),
+			ANSI_TO_TCHAR(Site->Location.file_name()), Site->Location.line(),
+			*FString(ANSI_TO_TCHAR(Site->Location.function_name())).Replace(TEXT("\""), TEXT("\"\"")),
+			*FString(Site->AwaitableType).Replace(TEXT("\""), TEXT("\"\"")),
+			Site->NumSuspended.load(), Site->NumReady.load(), CyclesToMs(Site->TotalCycles.load()),
+			GetPercentileMs(*Site, 0.5), GetPercentileMs(*Site, 0.99), CyclesToMs(Site->MaxCycles.load()));
+		for (const std::atomic<uint64>& Bucket : Site->Buckets)
+			Csv += FString::Printf(TEXT(",%llu"), Bucket.load());
+		Csv += LINE_TERMINATOR;
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *FileName))
+	{
+		UE_LOG(LogCoroTasks, Warning, TEXT("Can't write await latency to %s"), *FileName);
+		return false;
+	}
+	return true;
+}
+
+void FAwaitLatency::Reset()
+{
+	// Sites are never freed while the module is loaded: timed awaiters may be recording into them right now
+	FReadScopeLock Lock(SitesLock);
+	for (const auto& Pair : Sites)
+	{
+		FAwaitSite& Site = *Pair.Value;
+		Site.NumReady = 0;
+		Site.NumSuspended = 0;
+		Site.TotalCycles = 0;
+		Site.MaxCycles = 0;
+		for (std::atomic<uint64>& Bucket : Site.Buckets)
+			Bucket = 0;
+	}
+}
+
+#endif
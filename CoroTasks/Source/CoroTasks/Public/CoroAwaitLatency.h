@@ -0,0 +1,156 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CoroSupport.h"
+#include <source_location>
+
+#ifndef COROTASKS_WITH_AWAIT_LATENCY
+	#define COROTASKS_WITH_AWAIT_LATENCY 0
+#endif
+
+/**
+ * Tour to await latency:
+ * Compiled in only with bWithAwaitLatency in CoroTasks.Build.cs (never in Shipping).
+ * Every co_await inside of TTask goes through the promise's await_transform, which captures std::source_location
+ * of the co_await expression. When "CoroTasks.TrackAwaitLatency 1" is set, suspend-to-resume time is aggregated
+ * per call site (file:line plus awaitable type) into log2 histograms of microseconds.
+ *	1. CoroTasks.AwaitLatencyReport [Count]	- prints the slowest sites
+ *	2. CoroTasks.AwaitLatencyCsv [File]		- exports all sites to CSV (Saved/Profiling/CSV by default)
+ *	3. CoroTasks.AwaitLatencyReset			- clears collected data
+ * While tracking is on, every csvprofile capture resets the data on start and writes "<Capture>_AwaitLatency.csv" next to it.
+ */
+namespace CoroTasks
+{
+	struct FAwaitSite
+	{
+		static constexpr int32 NumBuckets = 32;
+
+		/** Bucket 0 is below 1us, bucket N is [2^(N-1), 2^N) us */
+		static int32 GetBucket(uint64 Microseconds)
+		{
+			return FMath::Min<int32>(Microseconds == 0 ? 0 : FMath::FloorLog2_64(Microseconds) + 1, NumBuckets - 1);
+		}
+
+		std::source_location Location;
+		const TCHAR* AwaitableType = nullptr;
+
+		std::atomic<uint64> NumReady{0};
+		std::atomic<uint64> NumSuspended{0};
+		std::atomic<uint64> TotalCycles{0};
+		std::atomic<uint64> MaxCycles{0};
+		std::atomic<uint64> Buckets[NumBuckets] = {};
+	};
+
+	struct COROTASKS_API FAwaitLatency
+	{
+		static bool bEnabled;
+
+		static FAwaitSite& FindOrAddSite(const std::source_location& Location, const TCHAR* AwaitableType);
+		static void RecordReady(const std::source_location& Location, const TCHAR* AwaitableType);
+		static void RecordResume(const std::source_location& Location, const TCHAR* AwaitableType, uint64 SuspendedCycles);
+
+		static void DumpReport(int32 Count);
+		static bool ExportCsv(const FString& FileName);
+		static void Reset();
+	};
+
+	namespace Private
+	{
+		COROTASKS_API FString ExtractTypeName(const TCHAR* FunctionSignature);
+
+		/** Type name from compiler's signature of this function, parsed once per type */
+		template<typename T>
+		const TCHAR* GetTypeName()
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			static const FString Name = ExtractTypeName(ANSI_TO_TCHAR(__FUNCSIG__));
+#else
+			static const FString Name = ExtractTypeName(ANSI_TO_TCHAR(__PRETTY_FUNCTION__));
+#endif
+			return *Name;
+		}
+
+		/** Applies operator co_await like the compiler does, so the wrapper sees the real awaiter */
+		template<typename AwaitableType>
+		decltype(auto) GetAwaiter(AwaitableType&& Awaitable)
+		{
+			if constexpr (requires { static_cast<AwaitableType&&>(Awaitable).operator co_await(); })
+				return static_cast<AwaitableType&&>(Awaitable).operator co_await();
+			else if constexpr (requires { operator co_await(static_cast<AwaitableType&&>(Awaitable)); })
+				return operator co_await(static_cast<AwaitableType&&>(Awaitable));
+			else
+				return static_cast<AwaitableType&&>(Awaitable);
+		}
+
+		/** Forwards everything to the real awaiter and measures time between suspend and resume */
+		template<typename AwaiterType>
+		struct TTimedAwaiter
+		{
+			bool await_ready()
+			{
+				if (!Awaiter.await_ready())
+					return false;
+				if (bEnabled)
+					FAwaitLatency::RecordReady(Location, TypeName);
+				return true;
+			}
+
+			template<typename PromiseType>
+			decltype(auto) await_suspend(std::coroutine_handle<PromiseType> Handle)
+			{
+				// Frame may be destroyed inside of await_suspend, so nothing is touched after the call
+				StartCycles = bEnabled ? FPlatformTime::Cycles64() : 0;
+				return Awaiter.await_suspend(Handle);
+			}
+
+			decltype(auto) await_resume()
+			{
+				if (StartCycles != 0)
+					FAwaitLatency::RecordResume(Location, TypeName, FPlatformTime::Cycles64() - StartCycles);
+				return Awaiter.await_resume();
+			}
+
+			AwaiterType Awaiter;
+			std::source_location Location;
+			const TCHAR* TypeName;
+			uint64 StartCycles;
+			bool bEnabled;
+		};
+
+		template<typename AwaitableType>
+		auto MakeTimedAwaiter(AwaitableType&& Awaitable, const std::source_location& Location)
+		{
+			using AwaiterType = decltype(GetAwaiter(static_cast<AwaitableType&&>(Awaitable)));
+			return TTimedAwaiter<AwaiterType>{
+				GetAwaiter(static_cast<AwaitableType&&>(Awaitable)),
+				Location,
+				GetTypeName<std::remove_cvref_t<AwaitableType>>(),
+				0,
+				FAwaitLatency::bEnabled
+			};
+		}
+	}
+}
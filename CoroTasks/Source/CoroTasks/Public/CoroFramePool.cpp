@@ -0,0 +1,162 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroFramePool.h"
+#include "CoroFramePoolCore.h"
+#include "CoroTasks.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformStackWalk.h"
+
+#include <atomic>
+
+using namespace CoroTasks;
+
+namespace
+{
+	struct FUnrealFrameAllocator
+	{
+		static void* Malloc(SIZE_T Size)
+		{
+			return FMemory::Malloc(Size);
+		}
+
+		static void Free(void* Ptr)
+		{
+			FMemory::Free(Ptr);
+		}
+	};
+
+	using FFramePool = Core::TFramePool<FUnrealFrameAllocator>;
+
+#if COROTASKS_FRAME_STATS
+	std::atomic<int64> NumLiveFrames = 0;
+	std::atomic<int64> PeakLiveFrames = 0;
+#endif
+}
+
+void* FCoroFramePool::Allocate(SIZE_T Size)
+{
+#if COROTASKS_FRAME_STATS
+	const int64 NumLive = NumLiveFrames.fetch_add(1, std::memory_order_relaxed) + 1;
+	int64 Peak = PeakLiveFrames.load(std::memory_order_relaxed);
+	while (NumLive > Peak && !PeakLiveFrames.compare_exchange_weak(Peak, NumLive, std::memory_order_relaxed))
+	{
+	}
+#endif
+	return FFramePool::Allocate(Size);
+}
+
+void FCoroFramePool::Free(void* Ptr, SIZE_T Size)
+{
+#if COROTASKS_FRAME_STATS
+	NumLiveFrames.fetch_sub(1, std::memory_order_relaxed);
+#endif
+	FFramePool::Free(Ptr, Size);
+}
+
+int64 FCoroFramePool::GetNumLiveFrames()
+{
+#if COROTASKS_FRAME_STATS
+	return NumLiveFrames.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
+
+int64 FCoroFramePool::GetPeakLiveFrames()
+{
+#if COROTASKS_FRAME_STATS
+	return PeakLiveFrames.load(std::memory_order_relaxed);
+#else
+	return 0;
+#endif
+}
+
+void FCoroFramePool::ResetPeakLiveFrames()
+{
+#if COROTASKS_FRAME_STATS
+	PeakLiveFrames.store(NumLiveFrames.load(std::memory_order_relaxed), std::memory_order_relaxed);
+#endif
+}
+
+namespace
+{
+	struct FFrameStatsEntry
+	{
+		SIZE_T Size = 0;
+		int64 NumAllocations = 0;
+	};
+
+	TAutoConsoleVariable<bool> CVarTrackFrameSizes(
+		TEXT("CoroTasks.TrackFrameSizes"),
+		false,
+		TEXT("Records coroutine frame sizes per coroutine function for CoroTasks.FrameSizeReport"));
+
+	FCriticalSection FrameStatsCriticalSection;
+	TMap<uint64, FFrameStatsEntry> FrameStats;
+
+	FAutoConsoleCommand FrameSizeReportCommand(
+		TEXT("CoroTasks.FrameSizeReport"),
+		TEXT("Prints the largest coroutine frames. Optional argument is count of printed functions (20 by default)"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([] (const TArray<FString>& Args)
+		{
+			FCoroFrameStats::DumpReport(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 20);
+		}));
+}
+
+bool FCoroFrameStats::IsEnabled()
+{
+	return CVarTrackFrameSizes.GetValueOnAnyThread();
+}
+
+void FCoroFrameStats::Record(const void* CoroutineFunction, SIZE_T Size)
+{
+	FScopeLock Lock(&FrameStatsCriticalSection);
+	FFrameStatsEntry& Entry = FrameStats.FindOrAdd((uint64)CoroutineFunction);
+	Entry.Size = FMath::Max(Entry.Size, Size);
+	++Entry.NumAllocations;
+}
+
+void FCoroFrameStats::DumpReport(int32 Count)
+{
+	TArray<TPair<uint64, FFrameStatsEntry>> Entries;
+	{
+		FScopeLock Lock(&FrameStatsCriticalSection);
+		Entries = FrameStats.Array();
+	}
+	Entries.Sort([] (const TPair<uint64, FFrameStatsEntry>& A, const TPair<uint64, FFrameStatsEntry>& B)
+	{
+		return A.Value.Size > B.Value.Size;
+	});
+
+	UE_LOG(LogCoroTasks, Display, TEXT("Coroutine frames (%d functions tracked):"), Entries.Num());
+	for (int32 Index = 0; Index < FMath::Min(Count, Entries.Num()); ++Index)
+	{
+		const TPair<uint64, FFrameStatsEntry>& Entry = Entries[Index];
+		FProgramCounterSymbolInfo SymbolInfo;
+		FPlatformStackWalk::ProgramCounterToSymbolInfo(Entry.Key, SymbolInfo);
+		UE_LOG(LogCoroTasks, Display, TEXT("%8llu bytes  %8lld frames  %s (%s:%d)"),
+			(uint64)Entry.Value.Size, Entry.Value.NumAllocations,
+			ANSI_TO_TCHAR(SymbolInfo.FunctionName), ANSI_TO_TCHAR(SymbolInfo.Filename), SymbolInfo.LineNumber);
+	}
+}
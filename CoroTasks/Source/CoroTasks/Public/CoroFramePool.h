@@ -0,0 +1,86 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CoroTrace.h"
+#include "CoroRegistry.h"
+
+/** Live frame counters cost two atomics per frame allocation, they are compiled in only with bWithFrameStats in CoroTasks.Build.cs */
+#ifndef COROTASKS_FRAME_STATS
+	#define COROTASKS_FRAME_STATS 0
+#endif
+
+/**
+ * Tour to frame allocation:
+ * Coroutine frame is allocated on each call of coroutine function. Promises that derive FPooledFrame
+ * take frames from per thread free lists bucketed by size, so hot coroutines and generators
+ * don't hit the general allocator after warm up.
+ * Frames bigger than the largest bucket go directly to FMemory.
+ * The pool itself is engine-independent (Core/CoroFramePoolCore.h), it's instantiated once in CoroFramePool.cpp
+ */
+namespace CoroTasks
+{
+	struct COROTASKS_API FCoroFramePool
+	{
+		static void* Allocate(SIZE_T Size);
+		static void Free(void* Ptr, SIZE_T Size);
+
+		/** Count of allocated and not yet freed frames on all threads, it's zero without COROTASKS_FRAME_STATS */
+		static int64 GetNumLiveFrames();
+		static int64 GetPeakLiveFrames();
+		static void ResetPeakLiveFrames();
+	};
+
+	/**
+	 * Frame size statistics, keyed by coroutine function (return address of the frame allocation).
+	 * Enable with "CoroTasks.TrackFrameSizes 1", print with "CoroTasks.FrameSizeReport [Count]"
+	 */
+	struct COROTASKS_API FCoroFrameStats
+	{
+		static bool IsEnabled();
+		static void Record(const void* CoroutineFunction, SIZE_T Size);
+		static void DumpReport(int32 Count);
+	};
+
+	struct FPooledFrame
+	{
+		/** Not inlined, so the return address points into the coroutine function that allocates the frame */
+		static FORCENOINLINE void* operator new(std::size_t Size)
+		{
+#if COROTASKS_FRAME_STATS
+			if (FCoroFrameStats::IsEnabled())
+				FCoroFrameStats::Record(PLATFORM_RETURN_ADDRESS(), Size);
+#endif
+			COROTASKS_TRACE(OnFrameAllocated, Size);
+			COROTASKS_REGISTRY(FCoroRegistry::OnFrameAllocated(PLATFORM_RETURN_ADDRESS(), Size));
+			return FCoroFramePool::Allocate(Size);
+		}
+
+		static void operator delete(void* Ptr, std::size_t Size)
+		{
+			FCoroFramePool::Free(Ptr, Size);
+		}
+	};
+}
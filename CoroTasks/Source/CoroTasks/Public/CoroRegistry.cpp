@@ -0,0 +1,311 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroRegistry.h"
+
+#if COROTASKS_WITH_REGISTRY
+
+#include "CoroTasks.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformStackWalk.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("CoroTasks"), STATGROUP_CoroTasks, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Live tasks"), STAT_CoroTasks_LiveTasks, STATGROUP_CoroTasks);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Live futures"), STAT_CoroTasks_LiveFutures, STATGROUP_CoroTasks);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Suspended coroutines"), STAT_CoroTasks_Suspended, STATGROUP_CoroTasks);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resumed per frame"), STAT_CoroTasks_Resumed, STATGROUP_CoroTasks);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Unregistered (table is full)"), STAT_CoroTasks_Dropped, STATGROUP_CoroTasks);
+
+using namespace CoroTasks;
+
+namespace
+{
+	/**
+	 * Slot holds node pointer. The lowest bit is set while dump copies the node,
+	 * unregistration waits for it, so the node can't be freed under the reader
+	 */
+	constexpr uintptr_t ReadingBit = 1;
+
+	std::atomic<uintptr_t> Slots[FCoroRegistry::MaxNodes];
+
+	/** Threads start probing from different places, so they don't fight for the same slots */
+	thread_local uint32 NextSlot = 0;
+
+	thread_local const void* PendingFunction = nullptr;
+	thread_local uint32 PendingFrameSize = 0;
+
+	void Register(FCoroRegistryNode* Node)
+	{
+		if (NextSlot == 0)
+			NextSlot = FPlatformTLS::GetCurrentThreadId() * 2654435761u;
+
+		for (int32 Probe = 0; Probe < FCoroRegistry::MaxNodes; ++Probe)
+		{
+			const int32 Index = (NextSlot++) & (FCoroRegistry::MaxNodes - 1);
+			uintptr_t Expected = 0;
+			if (Slots[Index].load(std::memory_order_relaxed) == 0
+				&& Slots[Index].compare_exchange_strong(Expected, (uintptr_t)Node, std::memory_order_release))
+			{
+				Node->Slot = Index;
+				return;
+			}
+		}
+		Node->Slot = INDEX_NONE;
+		INC_DWORD_STAT(STAT_CoroTasks_Dropped);
+	}
+
+	void Unregister(FCoroRegistryNode* Node)
+	{
+		if (Node->Slot == INDEX_NONE)
+			return;
+
+		uintptr_t Expected = (uintptr_t)Node;
+		while (!Slots[Node->Slot].compare_exchange_weak(Expected, 0, std::memory_order_acq_rel))
+		{
+			Expected = (uintptr_t)Node;
+			FPlatformProcess::YieldThread();
+		}
+	}
+
+	struct FNodeSnapshot
+	{
+		const void* Address;
+		const void* AwaitedBy;
+		const void* Function;
+		const TCHAR* AwaitableType;
+		uint64 AwaitStartCycles;
+		FName Detail;
+		uint32 FrameSize;
+		ECoroRegistryKind Kind;
+		ECoroRegistryState State;
+	};
+
+	TArray<FNodeSnapshot> TakeSnapshot()
+	{
+		TArray<FNodeSnapshot> Snapshot;
+		for (std::atomic<uintptr_t>& Slot : Slots)
+		{
+			uintptr_t Value = Slot.load(std::memory_order_acquire);
+			if (Value == 0 || !Slot.compare_exchange_strong(Value, Value | ReadingBit, std::memory_order_acquire))
+				continue;
+
+			const FCoroRegistryNode* Node = (const FCoroRegistryNode*)Value;
+			Snapshot.Add({Node->Address, Node->AwaitedBy, Node->Function, Node->AwaitableType,
+				Node->AwaitStartCycles, Node->Detail, Node->FrameSize, Node->Kind, Node->State});
+			Slot.store(Value, std::memory_order_release);
+		}
+		return Snapshot;
+	}
+
+	const TCHAR* LexToString(ECoroRegistryState State)
+	{
+		switch (State)
+		{
+		case ECoroRegistryState::Created: return TEXT("Created");
+		case ECoroRegistryState::Started: return TEXT("Started");
+		case ECoroRegistryState::Finished: return TEXT("Finished");
+		}
+		return TEXT("");
+	}
+
+	/** Symbolication is slow, every function is resolved once per dump */
+	struct FFunctionNames
+	{
+		const FString& Get(const void* Function)
+		{
+			if (const FString* Name = Names.Find(Function))
+				return *Name;
+			FString Name = TEXT("?");
+			if (Function)
+			{
+				FProgramCounterSymbolInfo SymbolInfo;
+				FPlatformStackWalk::ProgramCounterToSymbolInfo((uint64)Function, SymbolInfo);
+				Name = ANSI_TO_TCHAR(SymbolInfo.FunctionName);
+			}
+			return Names.Add(Function, MoveTemp(Name));
+		}
+
+		TMap<const void*, FString> Names;
+	};
+
+	FString Describe(const FNodeSnapshot& Node, FFunctionNames& FunctionNames, uint64 NowCycles)
+	{
+		FString Result = Node.Kind == ECoroRegistryKind::Task
+			? FString::Printf(TEXT("Task %p %s [%s, %u bytes]"), Node.Address, *FunctionNames.Get(Node.Function), LexToString(Node.State), Node.FrameSize)
+			: FString::Printf(TEXT("Future %p %s %s [%s]"), Node.Address, Node.AwaitableType ? Node.AwaitableType : TEXT("TFuture"),
+				*Node.Detail.ToString(), LexToString(Node.State));
+		if (Node.AwaitStartCycles != 0)
+		{
+			Result += FString::Printf(TEXT(" awaited by %p for %.1f ms"), Node.AwaitedBy,
+				FPlatformTime::ToMilliseconds64(NowCycles - Node.AwaitStartCycles));
+		}
+		return Result;
+	}
+
+	void DumpChildren(const TMultiMap<const void*, const FNodeSnapshot*>& Children, const FNodeSnapshot& Node,
+		FFunctionNames& FunctionNames, uint64 NowCycles, int32 Depth)
+	{
+		UE_LOG(LogCoroTasks, Display, TEXT("%s%s"), *FString::ChrN(Depth * 2, TEXT(' ')), *Describe(Node, FunctionNames, NowCycles));
+		if (Depth > 64)
+			return;
+
+		TArray<const FNodeSnapshot*> Awaited;
+		Children.MultiFind(Node.Address, Awaited);
+		for (const FNodeSnapshot* Child : Awaited)
+			DumpChildren(Children, *Child, FunctionNames, NowCycles, Depth + 1);
+	}
+
+	FAutoConsoleCommand ListCommand(
+		TEXT("CoroTasks.List"),
+		TEXT("Prints all live tasks and futures, the longest awaited first"),
+		FConsoleCommandDelegate::CreateStatic(&FCoroRegistry::DumpList));
+
+	FAutoConsoleCommand GraphCommand(
+		TEXT("CoroTasks.Graph"),
+		TEXT("Prints await chains of live tasks and futures"),
+		FConsoleCommandDelegate::CreateStatic(&FCoroRegistry::DumpGraph));
+}
+
+FCoroRegistryNode::FCoroRegistryNode(ECoroRegistryKind InKind)
+	: Address(this)
+	, AwaitedBy(nullptr)
+	, Function(nullptr)
+	, AwaitableType(nullptr)
+	, AwaitStartCycles(0)
+	, FrameSize(0)
+	, Slot(INDEX_NONE)
+	, Kind(InKind)
+	, State(ECoroRegistryState::Created)
+{
+	if (Kind == ECoroRegistryKind::Task)
+		INC_DWORD_STAT(STAT_CoroTasks_LiveTasks);
+	else
+		INC_DWORD_STAT(STAT_CoroTasks_LiveFutures);
+	Register(this);
+}
+
+FCoroRegistryNode::FCoroRegistryNode(const FCoroRegistryNode& Other)
+	: FCoroRegistryNode(Other.Kind)
+{
+	AwaitableType = Other.AwaitableType;
+	Detail = Other.Detail;
+	State = Other.State;
+}
+
+FCoroRegistryNode::~FCoroRegistryNode()
+{
+	Unregister(this);
+	if (AwaitStartCycles != 0)
+		DEC_DWORD_STAT(STAT_CoroTasks_Suspended);
+	if (Kind == ECoroRegistryKind::Task)
+		DEC_DWORD_STAT(STAT_CoroTasks_LiveTasks);
+	else
+		DEC_DWORD_STAT(STAT_CoroTasks_LiveFutures);
+}
+
+void FCoroRegistryNode::OnTaskCreated(const void* Frame)
+{
+	Address = Frame;
+	Function = PendingFunction;
+	FrameSize = PendingFrameSize;
+	PendingFunction = nullptr;
+	PendingFrameSize = 0;
+}
+
+void FCoroRegistryNode::OnAwaited(std::coroutine_handle<> Awaiter)
+{
+	AwaitedBy = Awaiter.address();
+	AwaitStartCycles = FPlatformTime::Cycles64();
+	INC_DWORD_STAT(STAT_CoroTasks_Suspended);
+}
+
+void FCoroRegistryNode::OnAwaitResumed()
+{
+	if (AwaitStartCycles == 0)
+		return;
+	AwaitStartCycles = 0;
+	DEC_DWORD_STAT(STAT_CoroTasks_Suspended);
+	INC_DWORD_STAT(STAT_CoroTasks_Resumed);
+}
+
+void FCoroRegistry::OnFrameAllocated(const void* Function, SIZE_T Size)
+{
+	PendingFunction = Function;
+	PendingFrameSize = (uint32)Size;
+}
+
+void FCoroRegistry::OnContinuationCaptured()
+{
+	INC_DWORD_STAT(STAT_CoroTasks_Suspended);
+}
+
+void FCoroRegistry::OnContinuationResumed()
+{
+	DEC_DWORD_STAT(STAT_CoroTasks_Suspended);
+	INC_DWORD_STAT(STAT_CoroTasks_Resumed);
+}
+
+void FCoroRegistry::DumpList()
+{
+	TArray<FNodeSnapshot> Snapshot = TakeSnapshot();
+	Snapshot.Sort([] (const FNodeSnapshot& A, const FNodeSnapshot& B)
+	{
+		// Not awaited nodes go last
+		return A.AwaitStartCycles - 1 < B.AwaitStartCycles - 1;
+	});
+
+	const uint64 NowCycles = FPlatformTime::Cycles64();
+	FFunctionNames FunctionNames;
+	UE_LOG(LogCoroTasks, Display, TEXT("Live coroutines and futures: %d"), Snapshot.Num());
+	for (const FNodeSnapshot& Node : Snapshot)
+		UE_LOG(LogCoroTasks, Display, TEXT("  %s"), *Describe(Node, FunctionNames, NowCycles));
+}
+
+void FCoroRegistry::DumpGraph()
+{
+	const TArray<FNodeSnapshot> Snapshot = TakeSnapshot();
+
+	TSet<const void*> Addresses;
+	TMultiMap<const void*, const FNodeSnapshot*> Children;
+	for (const FNodeSnapshot& Node : Snapshot)
+	{
+		Addresses.Add(Node.Address);
+		if (Node.AwaitStartCycles != 0)
+			Children.Add(Node.AwaitedBy, &Node);
+	}
+
+	const uint64 NowCycles = FPlatformTime::Cycles64();
+	FFunctionNames FunctionNames;
+	UE_LOG(LogCoroTasks, Display, TEXT("Await graph of %d live coroutines and futures:"), Snapshot.Num());
+	for (const FNodeSnapshot& Node : Snapshot)
+	{
+		// Roots are not awaited by anything, or are awaited by a coroutine that isn't a task (generator, foreign coroutine)
+		const bool bIsRoot = Node.AwaitStartCycles == 0 || !Addresses.Contains(Node.AwaitedBy);
+		if (bIsRoot && (Node.AwaitStartCycles != 0 || Children.Contains(Node.Address)))
+			DumpChildren(Children, Node, FunctionNames, NowCycles, 1);
+	}
+}
+
+#endif
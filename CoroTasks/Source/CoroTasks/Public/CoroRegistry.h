@@ -0,0 +1,123 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CoroSupport.h"
+
+#ifndef COROTASKS_WITH_REGISTRY
+	#define COROTASKS_WITH_REGISTRY 0
+#endif
+
+/**
+ * Tour to the registry:
+ * Opt-in (CoroTasks.Build.cs, bWithRegistry) registry of all live tasks and futures. Every promise and future
+ * embeds FCoroRegistryNode, that is published in a fixed table of slots with a single CAS on construction
+ * and removed with a single CAS on destruction, so there are no locks and no allocations.
+ *	1. CoroTasks.List	- every live task and future: state, what it awaits, how long it is awaited and frame bytes
+ *	2. CoroTasks.Graph	- await chains, from top level tasks down to futures they wait for
+ *	3. stat CoroTasks	- live tasks and futures, suspended coroutines and resumes per frame
+ *
+ * Futures can describe themselves, so dumps show what exactly is awaited:
+ *	>>> COROTASKS_REGISTRY(Future->RegistryNode.Describe(TEXT("LoadSingleObject"), FName(*Path.ToString())));
+ */
+#if COROTASKS_WITH_REGISTRY
+	#define COROTASKS_REGISTRY(...) __VA_ARGS__
+#else
+	#define COROTASKS_REGISTRY(...)
+#endif
+
+namespace CoroTasks
+{
+	enum class ECoroRegistryKind : uint8
+	{
+		Task,
+		Future,
+	};
+
+	enum class ECoroRegistryState : uint8
+	{
+		Created,
+		Started,
+		Finished,
+	};
+
+	struct COROTASKS_API FCoroRegistryNode
+	{
+		explicit FCoroRegistryNode(ECoroRegistryKind InKind);
+		FCoroRegistryNode(const FCoroRegistryNode& Other);
+		~FCoroRegistryNode();
+
+		FCoroRegistryNode& operator=(const FCoroRegistryNode&) = delete;
+
+		/** Tasks are known by frame address, the same id as in trace */
+		void OnTaskCreated(const void* Frame);
+
+		void SetState(ECoroRegistryState InState)
+		{
+			State = InState;
+		}
+
+		/** Coroutine is suspended until this task or future resumes it */
+		void OnAwaited(std::coroutine_handle<> Awaiter);
+		void OnAwaitResumed();
+
+		/** Type is a literal, Detail is anything that identifies the operation: asset path, latent action id... */
+		void Describe(const TCHAR* InAwaitableType, FName InDetail)
+		{
+			AwaitableType = InAwaitableType;
+			Detail = InDetail;
+		}
+
+		/** Values are written without synchronization, dumps read them as best-effort snapshot */
+		const void* Address;
+		const void* AwaitedBy;
+		const void* Function;
+		const TCHAR* AwaitableType;
+		uint64 AwaitStartCycles;
+		FName Detail;
+		uint32 FrameSize;
+		int32 Slot;
+		ECoroRegistryKind Kind;
+		ECoroRegistryState State;
+	};
+
+	struct COROTASKS_API FCoroRegistry
+	{
+		static constexpr int32 MaxNodes = 1 << 16;
+
+		/** Called by frame allocator, frame is allocated right before its promise (and its node) is created */
+		static void OnFrameAllocated(const void* Function, SIZE_T Size);
+
+		/** Suspensions through FContinuation (primitives, channels), they are only counted */
+		static void OnContinuationCaptured();
+		static void OnContinuationResumed();
+
+		static void DumpList();
+		static void DumpGraph();
+	};
+
+	/** Size that registry adds to every promise and future, it's a part of their size budgets */
+	constexpr SIZE_T RegistryNodeSize = COROTASKS_WITH_REGISTRY ? sizeof(FCoroRegistryNode) : 0;
+}
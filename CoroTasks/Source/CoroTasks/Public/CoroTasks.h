@@ -26,6 +26,8 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+COROTASKS_API DECLARE_LOG_CATEGORY_EXTERN(LogCoroTasks, Log, All);
+
 class FCoroTasksModule : public IModuleInterface
 {
 public:
@@ -0,0 +1,54 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CoroTasksStressCommandlet.generated.h"
+
+/**
+ * Tour to stress runs:
+ * Headless end-to-end scenarios for the nightly perf pipeline
+ *	1. Pipeline			- StressCoroutineCount coroutines, each one waits StressDelayFrames frames, loads TestObjectToLoad,
+ *							computes and spawns StressActorClass in a temporary game world
+ *	2. MassCancellation	- the same count of suspended coroutines is destroyed by TTask::Cancel at once
+ *	3. DeepRecursion		- await chain of StressRecursionDepth tasks
+ * Each scenario reports p50/p99 frame time, peak live coroutine frames, bytes allocated by the game thread and throughput.
+ * Peak live frames is counted only with bWithFrameStats in CoroTasks.Build.cs, otherwise it's reported as zero.
+ * Defaults come from UCoroTasksTestsSettings, command line overrides them:
+ * >>> UnrealEditor-Cmd Project.uproject -run=CoroTasksStress -unattended -nullrhi [-Count=N] [-Depth=N] [-Output=Path.json|Path.csv]
+ * Output is Saved/Stress/CoroTasksStress.json by default. Commandlet returns non zero if a scenario didn't finish in StressMaxFrames
+ */
+UCLASS()
+class COROTASKS_API UCoroTasksStressCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCoroTasksStressCommandlet();
+
+	// BEGIN UCommandlet
+	virtual int32 Main(const FString& Params) override;
+	// END UCommandlet
+};
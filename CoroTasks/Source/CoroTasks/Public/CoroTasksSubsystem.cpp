@@ -22,6 +22,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "CoroTasksSubsystem.h"
+#include "Engine/Engine.h"
 
 void UCoroTasksSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
@@ -37,16 +38,37 @@ void UCoroTasksSubsystem::Deinitialize()
 }
 
 bool UCoroTasksSubsystem::Tick(float DeltaTime)
+{
+	if (!bVirtualClock)
+		ProcessTimers();
+	ProcessPollingActions();
+	return true;
+}
+
+void UCoroTasksSubsystem::ProcessTimers()
+{
+	const double Now = GetTime();
+	while (Timers.Num() > 0 && Timers.HeapTop().Time <= Now)
+	{
+		FCoroTasksTimer Timer = Timers.HeapTop();
+		Timers.HeapPopDiscard();
+		Timer.Future->SetResult();
+	}
+}
+
+void UCoroTasksSubsystem::ProcessPollingActions()
 {
 	if (PendingFutures.Num() > 0)
 	{
-		for (auto& LatentInfo : PendingFutures)
+		// Resumed coroutines may add new actions, so the array is walked by index
+		for (int32 Index = 0; Index < PendingFutures.Num(); ++Index)
 		{
+			FCoroTasksLatentActionInfo& LatentInfo = PendingFutures[Index];
 			if (LatentInfo.bIsPolling && !LatentInfo.bIsFinished)
 			{
 				if (LatentInfo.Delegate.IsBound() && LatentInfo.Delegate.Execute())
 				{
-					LatentInfo.bIsFinished = true;
+					PendingFutures[Index].bIsFinished = true;
 				}
 			}
 		}
@@ -55,5 +77,95 @@ bool UCoroTasksSubsystem::Tick(float DeltaTime)
 			return Info.bIsFinished;
 		});
 	}
-	return true;
+}
+
+TSharedRef<CoroTasks::TFuture<void>> UCoroTasksSubsystem::CreateDelay(double Seconds)
+{
+	auto Future = MakeShared<CoroTasks::TFuture<void>>();
+	COROTASKS_REGISTRY(Future->RegistryNode.Describe(TEXT("Delay"), NAME_None));
+	if (Seconds <= 0.0)
+	{
+		Future->SetResult();
+		return Future;
+	}
+	Timers.HeapPush(FCoroTasksTimer{GetTime() + Seconds, TimerSequence++, Future});
+	return Future;
+}
+
+double UCoroTasksSubsystem::GetTime() const
+{
+	return bVirtualClock ? VirtualTime : FPlatformTime::Seconds();
+}
+
+void UCoroTasksSubsystem::SetVirtualClock(bool bEnable)
+{
+	if (bVirtualClock == bEnable)
+		return;
+
+	const double RealTime = FPlatformTime::Seconds();
+	if (bEnable)
+	{
+		// Virtual clock starts at real time, so pending delays keep their deadlines
+		VirtualTime = RealTime;
+	}
+	else
+	{
+		// Virtual clock went away from real time: pending delays are shifted by that, so they keep their remaining time
+		const double Offset = RealTime - VirtualTime;
+		for (FCoroTasksTimer& Timer : Timers)
+			Timer.Time += Offset;
+	}
+	bVirtualClock = bEnable;
+}
+
+void UCoroTasksSubsystem::AdvanceVirtualClock(double Seconds)
+{
+	check(bVirtualClock);
+	const double Target = VirtualTime + Seconds;
+	while (VirtualTime < Target && StepVirtualClock(Target))
+	{
+	}
+	VirtualTime = FMath::Max(VirtualTime, Target);
+	ProcessTimers();
+	ProcessPollingActions();
+}
+
+bool UCoroTasksSubsystem::RunVirtualClock(TFunctionRef<bool()> IsDone, double MaxSeconds)
+{
+	check(bVirtualClock);
+	const double Limit = VirtualTime + MaxSeconds;
+	while (!IsDone() && VirtualTime < Limit)
+	{
+		if (!StepVirtualClock(Limit))
+			break;
+	}
+	return IsDone();
+}
+
+bool UCoroTasksSubsystem::StepVirtualClock(double Limit)
+{
+	ProcessTimers();
+	ProcessPollingActions();
+
+	double NextTime = Limit;
+	bool bHasWork = false;
+	if (PendingFutures.ContainsByPredicate([] (const FCoroTasksLatentActionInfo& Info) { return Info.bIsPolling; }))
+	{
+		NextTime = FMath::Min(NextTime, VirtualTime + VirtualFrameSeconds);
+		bHasWork = true;
+	}
+	if (Timers.Num() > 0)
+	{
+		NextTime = FMath::Min(NextTime, Timers.HeapTop().Time);
+		bHasWork = true;
+	}
+	VirtualTime = FMath::Max(VirtualTime, NextTime);
+	return bHasWork;
+}
+
+TSharedRef<CoroTasks::TFuture<void>> CoroTasks::Delay(double Seconds)
+{
+	UCoroTasksSubsystem* Subsystem = GEngine->GetEngineSubsystem<UCoroTasksSubsystem>();
+	check(Subsystem);
+	return Subsystem->CreateDelay(Seconds);
 }
@@ -47,8 +47,30 @@ struct FCoroTasksLatentActionInfo
 	bool bIsFinished;
 };
 
+struct FCoroTasksTimer
+{
+	double Time;
+	uint64 Sequence;
+	TSharedRef<CoroTasks::TFuture<void>> Future;
+
+	/** Equal deadlines fire in order of creation, so virtual clock runs are deterministic */
+	bool operator<(const FCoroTasksTimer& Other) const
+	{
+		return Time < Other.Time || (Time == Other.Time && Sequence < Other.Sequence);
+	}
+};
+
 /**
- * 
+ * Tour to time:
+ * Delays and polling actions are driven by this subsystem. Time of delays comes from GetTime(), which is either
+ * real time or a virtual clock. Virtual clock is for tests: nothing advances it but the test driver,
+ * so hours of delays are fast-forwarded in a tight loop and results don't depend on frame rate
+ * >>> co_await CoroTasks::Delay(2.f);
+ *
+ * >>> Subsystem->SetVirtualClock(true);
+ * >>> Task.Launch();
+ * >>> Subsystem->AdvanceVirtualClock(60.0);		// resumes every delay that ends in the next minute, in order
+ * >>> Subsystem->SetVirtualClock(false);
  */
 UCLASS()
 class COROTASKS_API UCoroTasksSubsystem : public UEngineSubsystem
@@ -76,13 +98,69 @@ public:
 	{
 		auto Future = MakeShared<CoroTasks::TFuture<ResultType>>();
 		const FCoroTasksLatentActionInfo Info(Future, IdCounter++);
+		COROTASKS_REGISTRY(Future->RegistryNode.Describe(TEXT("LatentAction"), FName(TEXT("LatentAction"), NAME_EXTERNAL_TO_INTERNAL(Info.Id))));
 		PendingFutures.Add(Info);
 		return PendingFutures.Last();
 	}
 
-private:
+	TSharedRef<CoroTasks::TFuture<void>> CreateDelay(double Seconds);
+
+	double GetTime() const;
+
+	/**
+	 * While virtual clock is enabled, delays are resumed only by AdvanceVirtualClock and RunVirtualClock.
+	 * It starts at real time, pending delays keep their remaining time when it's switched on or off
+	 */
+	void SetVirtualClock(bool bEnable);
+
+	bool IsVirtualClock() const
+	{
+		return bVirtualClock;
+	}
+
+	/** Moves virtual clock forward, resuming delays at their deadlines and polling actions once per virtual frame */
+	void AdvanceVirtualClock(double Seconds);
+
+	/**
+	 * Fast-forwards virtual clock until IsDone returns true, nothing is scheduled (coroutines wait for something else,
+	 * e.g. asset loading) or MaxSeconds of virtual time have passed. Returns IsDone()
+	 */
+	bool RunVirtualClock(TFunctionRef<bool()> IsDone, double MaxSeconds);
+
+	/** Step of virtual clock for polling actions */
+	static constexpr double VirtualFrameSeconds = 1.0 / 60.0;
+
+	/** Delays that haven't fired yet */
+	int32 GetNumPendingTimers() const
+	{
+		return Timers.Num();
+	}
+
+	/** Latent and polling actions that haven't finished yet */
+	int32 GetNumPendingActions() const
+	{
+		return PendingFutures.Num();
+	}
+
+	/** Core ticker callback, resumes due delays and polls actions. Called directly only by benchmarks */
 	bool Tick(float DeltaTime);
 
+private:
+	void ProcessTimers();
+
+	void ProcessPollingActions();
+
+	/** Resumes due work and moves virtual clock to the next event not later than Limit. Returns false if nothing is scheduled */
+	bool StepVirtualClock(double Limit);
+
+	TArray<FCoroTasksTimer> Timers;
+
+	uint64 TimerSequence = 0;
+
+	double VirtualTime = 0.0;
+
+	bool bVirtualClock = false;
+
 	FTSTicker::FDelegateHandle TickerHandle;
 
 	TArray<FCoroTasksLatentActionInfo> PendingFutures;
@@ -90,3 +168,9 @@ private:
 	int32 IdCounter;
 	
 };
+
+namespace CoroTasks
+{
+	/** Resumes awaiting coroutine after Seconds of UCoroTasksSubsystem time (see UCoroTasksSubsystem::GetTime) */
+	COROTASKS_API TSharedRef<TFuture<void>> Delay(double Seconds);
+}
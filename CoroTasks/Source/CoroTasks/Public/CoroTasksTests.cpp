@@ -24,18 +24,59 @@
 #include "CoroTasksTests.h"
 
 #include "AsyncException.h"
+#include "AsyncSync.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "CoroTasksSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 
+namespace
+{
+	TAutoConsoleVariable<bool> CVarTestsVirtualClock(
+		TEXT("CoroTasks.Tests.VirtualClock"),
+		false,
+		TEXT("Runs all async automation tests on virtual clock, delays are fast-forwarded"));
+
+	TAutoConsoleVariable<float> CVarTestsVirtualSecondsPerFrame(
+		TEXT("CoroTasks.Tests.VirtualSecondsPerFrame"),
+		86400.f,
+		TEXT("Max virtual time fast-forwarded by an async test in one engine frame"));
+
+	TAutoConsoleVariable<FString> CVarTestsConcurrentFilter(
+		TEXT("CoroTasks.Tests.ConcurrentFilter"),
+		TEXT("CoroTasks."),
+		TEXT("Prefix of async tests run by CoroTasksRunner.ConcurrentAsyncTests"));
+
+	TAutoConsoleVariable<int32> CVarTestsConcurrency(
+		TEXT("CoroTasks.Tests.Concurrency"),
+		8,
+		TEXT("Max count of async tests running at once in CoroTasksRunner.ConcurrentAsyncTests"));
+
+	UCoroTasksSubsystem* GetCoroTasksSubsystem()
+	{
+		return GEngine ? GEngine->GetEngineSubsystem<UCoroTasksSubsystem>() : nullptr;
+	}
+}
 
 bool FNetworkedTests_RunAsyncTest::Update()
 {
 	if (!bExecuted)
 	{
 		bExecuted = true;
+		Test.SetVirtualClockActive(Test.UsesVirtualClock());
 		Test.LaunchTest(Parameters);
 	}
 
-	if (Delegate.IsBound())
-		return Delegate.Execute();
+	// Everything that is ready is drained right here, the rest (e.g. asset loading) is waited for in real frames
+	if (Test.bVirtualClockActive)
+		GetCoroTasksSubsystem()->RunVirtualClock([this] { return Test.bIsFinished; }, CVarTestsVirtualSecondsPerFrame.GetValueOnGameThread());
+
+	if (Delegate.IsBound() && Delegate.Execute())
+	{
+		Test.SetVirtualClockActive(false);
+		return true;
+	}
 	
 	return false;
 }
@@ -68,17 +109,173 @@ CoroTasks::TTask<bool> FAsyncAutomationTestBase::AsyncTest(const FString Paramet
 {
 	SetSuccessState(true);
 	bSuppressLogs = true;
+#if COROTASKS_WITH_EXCEPTIONS
 	try
 	{
 		co_await RunTest_Async(Parameters);
-	} catch (const FAsyncTestException& Exc)
+	} catch (const FAsyncException& Exc)
 	{
-		bSuppressLogs = false;
-		const FString& ErrorMessage = Exc.GetMessage();
-		UE_LOG(LogTemp, Error, TEXT("Test failed with reason: %s"), *ErrorMessage);
-		AddError(ErrorMessage);
-		SetSuccessState(false);
+		OnTestFailed(Exc);
 	}
+#else
+	auto Result = co_await RunTest_Async(Parameters);
+	if (Result.HasError())
+		OnTestFailed(Result.GetError());
+#endif
 	bIsFinished = true;
 	co_return true;
 }
+
+void FAsyncAutomationTestBase::OnTestFailed(const FAsyncException& Error)
+{
+	bSuppressLogs = false;
+	const FString& ErrorMessage = Error.GetMessage();
+	UE_LOG(LogTemp, Error, TEXT("Test failed with reason: %s"), *ErrorMessage);
+	AddError(ErrorMessage);
+	SetSuccessState(false);
+}
+
+bool FAsyncAutomationTestBase::UsesVirtualClock() const
+{
+	return CVarTestsVirtualClock.GetValueOnGameThread();
+}
+
+void FAsyncAutomationTestBase::SetVirtualClockActive(bool bActive)
+{
+	UCoroTasksSubsystem* Subsystem = GetCoroTasksSubsystem();
+	bActive &= Subsystem != nullptr;
+	if (bActive == bVirtualClockActive)
+		return;
+
+	bVirtualClockActive = bActive;
+	Subsystem->SetVirtualClock(bActive);
+}
+
+TArray<FAsyncAutomationTestBase*>& FAsyncAutomationTestBase::GetAsyncTests()
+{
+	static TArray<FAsyncAutomationTestBase*> Tests;
+	return Tests;
+}
+
+TArray<FAsyncAutomationTestBase*> FConcurrentAsyncTests::Collect(const FString& Prefix, const FAsyncAutomationTestBase* Exclude)
+{
+	TArray<FAsyncAutomationTestBase*> Tests = FAsyncAutomationTestBase::GetAsyncTests().FilterByPredicate([&] (const FAsyncAutomationTestBase* Test)
+	{
+		return Test != Exclude && Test->GetAsyncTestName().StartsWith(Prefix);
+	});
+	Tests.Sort([] (const FAsyncAutomationTestBase& A, const FAsyncAutomationTestBase& B)
+	{
+		return A.GetAsyncTestName() < B.GetAsyncTestName();
+	});
+	return Tests;
+}
+
+namespace
+{
+	CoroTasks::TTask<> RunConcurrentTest(FAsyncAutomationTestBase& Test, CoroTasks::FAsyncSemaphore& Semaphore,
+		TFunction<void(const FConcurrentAsyncTests::FTestResult&)> OnTestFinished)
+	{
+		auto Permit = co_await Semaphore.AcquireScoped();
+		const double StartTime = FPlatformTime::Seconds();
+		Test.ClearExecutionInfo();
+		Test.bIsFinished = false;
+		co_await Test.AsyncTest(FString());
+		// Permit is released first: the last callback may finish the batch and free the semaphore
+		Permit.Release();
+		OnTestFinished({&Test, FPlatformTime::Seconds() - StartTime});
+	}
+}
+
+CoroTasks::TTask<> FConcurrentAsyncTests::Run(TArray<FAsyncAutomationTestBase*> Tests, int32 Concurrency, TFunction<void(const FTestResult&)> OnTestFinished)
+{
+	if (Tests.Num() == 0)
+		co_return;
+
+	CoroTasks::FAsyncSemaphore Semaphore(FMath::Max(Concurrency, 1));
+	CoroTasks::FAsyncEvent AllFinished(EEventMode::ManualReset);
+	int32 NumRemaining = Tests.Num();
+	for (FAsyncAutomationTestBase* Test : Tests)
+	{
+		RunConcurrentTest(*Test, Semaphore, [&] (const FTestResult& Result)
+		{
+			OnTestFinished(Result);
+			if (--NumRemaining == 0)
+				AllFinished.Trigger();
+		}).Launch();
+	}
+	co_await AllFinished.Wait();
+}
+
+IMPLEMENT_ASYNC_AUTOMATION_TEST(Test_ConcurrentAsyncTests, "CoroTasksRunner.ConcurrentAsyncTests",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::StressFilter);
+
+CoroTasks::TTask<void> Test_ConcurrentAsyncTests::RunTest_Async(const FString Parameters)
+{
+	const TArray<FAsyncAutomationTestBase*> Tests = FConcurrentAsyncTests::Collect(CVarTestsConcurrentFilter.GetValueOnGameThread(), this);
+	const int32 Concurrency = CVarTestsConcurrency.GetValueOnGameThread();
+	const double StartTime = FPlatformTime::Seconds();
+	double SerialSeconds = 0.0;
+	int32 NumFailed = 0;
+
+	auto OnTestFinished = [&] (const FConcurrentAsyncTests::FTestResult& Result)
+	{
+		SerialSeconds += Result.Seconds;
+		FAutomationTestExecutionInfo ExecutionInfo;
+		Result.Test->GetExecutionInfo(ExecutionInfo);
+		const FString TestName = Result.Test->GetAsyncTestName();
+		bool bFailed = false;
+		for (const FAutomationExecutionEntry& Entry : ExecutionInfo.GetEntries())
+		{
+			if (Entry.Event.Type == EAutomationEventType::Error)
+			{
+				AddError(FString::Printf(TEXT("[%s] %s"), *TestName, *Entry.Event.Message));
+				bFailed = true;
+			}
+		}
+		NumFailed += bFailed ? 1 : 0;
+		AddInfo(FString::Printf(TEXT("%s %s (%.2f s)"), bFailed ? TEXT("FAIL") : TEXT(" OK "), *TestName, Result.Seconds));
+	};
+
+	// Virtual clock is global, so tests that use it run in their own batch, with the clock driven by this test's latent command
+	const TArray<FAsyncAutomationTestBase*> RealClockTests = Tests.FilterByPredicate([] (const FAsyncAutomationTestBase* Test) { return !Test->UsesVirtualClock(); });
+	const TArray<FAsyncAutomationTestBase*> VirtualClockTests = Tests.FilterByPredicate([] (const FAsyncAutomationTestBase* Test) { return Test->UsesVirtualClock(); });
+	const bool bVirtualClockWasActive = bVirtualClockActive;
+	SetVirtualClockActive(false);
+	co_await FConcurrentAsyncTests::Run(RealClockTests, Concurrency, OnTestFinished);
+	SetVirtualClockActive(true);
+	co_await FConcurrentAsyncTests::Run(VirtualClockTests, Concurrency, OnTestFinished);
+	SetVirtualClockActive(bVirtualClockWasActive);
+
+	AddInfo(FString::Printf(TEXT("%d tests, %d failed, %.2f s (%.2f s one by one) with concurrency %d"),
+		Tests.Num(), NumFailed, FPlatformTime::Seconds() - StartTime, SerialSeconds, Concurrency));
+}
+
+
+FCoroTestWorld::FCoroTestWorld()
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CoroTasksTestWorld"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+}
+
+FCoroTestWorld::~FCoroTestWorld()
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+}
+
+void FCoroTestWorld::Tick(float DeltaTime)
+{
+	++GFrameCounter;
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+	World->Tick(LEVELTICK_All, DeltaTime);
+}
+
+bool FCoroTestWorld::TickUntil(TFunctionRef<bool()> IsDone, int32 MaxFrames)
+{
+	for (int32 Frame = 0; Frame < MaxFrames && !IsDone(); ++Frame)
+		Tick();
+	return IsDone();
+}
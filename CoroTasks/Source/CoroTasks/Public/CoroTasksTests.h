@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "AsyncException.h"
 #include "CoroTask.h"
 #include "Coroutine.h"
 #include "Misc/AutomationTest.h"
@@ -59,6 +60,13 @@
 	};
 
 
+/** Fails async test with the message, works with and without exceptions */
+#if COROTASKS_WITH_EXCEPTIONS
+	#define ASYNC_TEST_FAIL(Message) throw FAsyncTestException(Message)
+#else
+	#define ASYNC_TEST_FAIL(Message) CORO_FAIL(FCoroError(Message))
+#endif
+
 #define IMPLEMENT_ASYNC_AUTOMATION_TEST( TClass, PrettyName, TFlags, ... ) \
 	IMPLEMENT_ASYNC_TEST_PRIVATE(TClass, FAsyncAutomationTestBase, PrettyName, TFlags, __FILE__, __LINE__, ##__VA_ARGS__) \
 	namespace\
@@ -66,6 +74,17 @@
 		TClass TClass##AutomationTestInstance( TEXT(#TClass), ##__VA_ARGS__ );\
 	}
 
+/**
+ * Async test that runs on virtual clock: delays and polling actions are fast-forwarded by the test driver
+ * (see UCoroTasksSubsystem::RunVirtualClock). "CoroTasks.Tests.VirtualClock 1" enables it for all async tests
+ */
+#define IMPLEMENT_ASYNC_AUTOMATION_TEST_VIRTUAL_CLOCK( TClass, PrettyName, TFlags, ... ) \
+	IMPLEMENT_ASYNC_TEST_PRIVATE(TClass, FVirtualClockAutomationTestBase, PrettyName, TFlags, __FILE__, __LINE__, ##__VA_ARGS__) \
+	namespace\
+	{\
+		TClass TClass##AutomationTestInstance( TEXT(#TClass), ##__VA_ARGS__ );\
+	}
+
 DECLARE_DELEGATE_RetVal(bool, FSimpleDelegate_Bool);
 
 class COROTASKS_API FAsyncAutomationTestBase : public FAutomationTestBase
@@ -74,8 +93,23 @@ public:
 	FAsyncAutomationTestBase(const FString& InName, bool bInComplexTask)
 		: FAutomationTestBase(InName, bInComplexTask)
 		, bIsFinished(false)
+		, bVirtualClockActive(false)
 	{
 		bSuppressLogs = true;
+		GetAsyncTests().Add(this);
+	}
+
+	virtual ~FAsyncAutomationTestBase() override
+	{
+		GetAsyncTests().RemoveSingleSwap(this);
+	}
+
+	/** All registered async tests, used by FConcurrentAsyncTests */
+	static TArray<FAsyncAutomationTestBase*>& GetAsyncTests();
+
+	FString GetAsyncTestName() const
+	{
+		return GetBeautifiedTestName();
 	}
 
 	virtual bool RunTest(const FString& Parameters) override;
@@ -84,15 +118,96 @@ public:
 	virtual bool LaunchTest(const FString& Parameters);
 	virtual CoroTasks::TTask<bool> AsyncTest(const FString Parameters);
 	virtual CoroTasks::TTask<void> RunTest_Async(const FString Parameters) = 0;
+	virtual void OnTestFailed(const FAsyncException& Error);
+
+	/** Checked once when the test is launched */
+	virtual bool UsesVirtualClock() const;
+
+	/** While active, the latent command of this test fast-forwards delays every frame */
+	void SetVirtualClockActive(bool bActive);
 	
 	FSimpleDelegate_Bool FinishedDelegate;
 
 	bool bIsFinished;
 
+	bool bVirtualClockActive;
+
 	TSharedPtr<class FNetworkedTests_RunAsyncTest> DummyCommand;
 };
 
 
+class COROTASKS_API FVirtualClockAutomationTestBase : public FAsyncAutomationTestBase
+{
+public:
+	FVirtualClockAutomationTestBase(const FString& InName, bool bInComplexTask)
+		: FAsyncAutomationTestBase(InName, bInComplexTask)
+	{
+	}
+
+	virtual bool UsesVirtualClock() const override
+	{
+		return true;
+	}
+};
+
+
+/**
+ * Tour to concurrent async tests:
+ * Async tests mostly wait for IO, so "CoroTasksRunner.ConcurrentAsyncTests" runs them at once inside of its own latent command.
+ * It's opt-in (stress filter, name outside of "CoroTasks."), so regular runs don't execute every async test twice.
+ * Every test is still its own instance: errors and FAsyncTestExceptions are recorded by the test that raised them
+ * and reported by the runner with the test name. Tests that use virtual clock run in a second batch with the clock enabled,
+ * the same way as when they run alone.
+ *	CoroTasks.Tests.ConcurrentFilter	- prefix of test names ("CoroTasks." by default)
+ *	CoroTasks.Tests.Concurrency			- max count of tests running at once (8 by default)
+ * Tests that share global state (e.g. virtual clock expectations, the same assets) shouldn't be run this way.
+ * Log lines are attributed to the runner, because the automation framework has only one current test
+ */
+struct COROTASKS_API FConcurrentAsyncTests
+{
+	struct FTestResult
+	{
+		FAsyncAutomationTestBase* Test;
+		double Seconds;
+	};
+
+	static TArray<FAsyncAutomationTestBase*> Collect(const FString& Prefix, const FAsyncAutomationTestBase* Exclude);
+
+	/** Finishes when all tests have finished. OnTestFinished is called right after each test */
+	static CoroTasks::TTask<> Run(TArray<FAsyncAutomationTestBase*> Tests, int32 Concurrency, TFunction<void(const FTestResult&)> OnTestFinished);
+};
+
+
+/**
+ * Game world for tests of world dependent awaitables (traces, navigation, tick groups, spawning).
+ * It begins play when created and is destroyed with all of its actors in destructor. Ticks are driven by the test:
+ * each Tick stands for an engine frame (GFrameCounter is advanced), so per-frame logic behaves like in game
+ */
+class COROTASKS_API FCoroTestWorld
+{
+public:
+	FCoroTestWorld();
+	~FCoroTestWorld();
+
+	FCoroTestWorld(const FCoroTestWorld&) = delete;
+	FCoroTestWorld& operator=(const FCoroTestWorld&) = delete;
+
+	UWorld* Get() const
+	{
+		return World;
+	}
+
+	/** Game thread tasks (e.g. async query results) and then the world tick */
+	void Tick(float DeltaTime = 1.f / 60.f);
+
+	/** Ticks until IsDone returns true, at most MaxFrames times. Returns IsDone() */
+	bool TickUntil(TFunctionRef<bool()> IsDone, int32 MaxFrames = 60);
+
+private:
+	UWorld* World;
+};
+
+
 DEFINE_LATENT_AUTOMATION_COMMAND_FOUR_PARAMETER(FNetworkedTests_RunAsyncTest,
 	FAsyncAutomationTestBase&, Test, FString, Parameters, FSimpleDelegate_Bool, Delegate, bool, bExecuted);
 
@@ -3,9 +3,12 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
 #include "UObject/Object.h"
 #include "CoroTasksTestsSettings.generated.h"
 
+class AActor;
+
 /**
  * 
  */
@@ -18,4 +21,24 @@ public:
 
 	UPROPERTY(EditAnywhere, Config, Category = "Test")
 	TSoftObjectPtr<UObject> TestObjectToLoad;
+
+	/** Actor spawned by each coroutine of -run=CoroTasksStress, AActor when empty */
+	UPROPERTY(EditAnywhere, Config, Category = "Stress")
+	TSoftClassPtr<AActor> StressActorClass;
+
+	UPROPERTY(EditAnywhere, Config, Category = "Stress", meta = (ClampMin = 1))
+	int32 StressCoroutineCount = 10000;
+
+	UPROPERTY(EditAnywhere, Config, Category = "Stress", meta = (ClampMin = 0))
+	int32 StressDelayFrames = 2;
+
+	UPROPERTY(EditAnywhere, Config, Category = "Stress", meta = (ClampMin = 0))
+	int32 StressComputeIterations = 1000;
+
+	UPROPERTY(EditAnywhere, Config, Category = "Stress", meta = (ClampMin = 1))
+	int32 StressRecursionDepth = 10000;
+
+	/** Scenario fails if it's still running after this count of frames */
+	UPROPERTY(EditAnywhere, Config, Category = "Stress", meta = (ClampMin = 1))
+	int32 StressMaxFrames = 10000;
 };
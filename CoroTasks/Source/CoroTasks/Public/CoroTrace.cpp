@@ -0,0 +1,186 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroTrace.h"
+
+#if COROTASKS_TRACE_ENABLED
+
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(CoroTasksChannel);
+
+UE_TRACE_EVENT_BEGIN(CoroTasks, TaskCreate)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, TaskId)
+	UE_TRACE_EVENT_FIELD(uint64, ParentId)
+	UE_TRACE_EVENT_FIELD(uint32, FrameSize)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(CoroTasks, TaskName)
+	UE_TRACE_EVENT_FIELD(uint64, TaskId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Name)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(CoroTasks, TaskLaunch)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, TaskId)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(CoroTasks, TaskSuspend)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, TaskId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, AwaitableType)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(CoroTasks, TaskResume)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, TaskId)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(CoroTasks, TaskComplete)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, TaskId)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(CoroTasks, TaskDestroy)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, TaskId)
+UE_TRACE_EVENT_END()
+
+using namespace CoroTasks;
+
+namespace
+{
+	/** Task that runs on this thread right now, it becomes parent of created tasks */
+	thread_local const void* CurrentTask = nullptr;
+
+	/** Size of the last frame allocated on this thread. Frame is allocated right before its promise is created */
+	thread_local uint32 PendingFrameSize = 0;
+
+	/** CPU profiler event types of named tasks. Touched only while the channel is on */
+	FCriticalSection TaskNamesCriticalSection;
+	TMap<uint64, uint32> TaskNames;
+	TMap<FString, uint32> EventTypes;
+
+	uint32 GetTaskEventType(const void* Task)
+	{
+		{
+			FScopeLock Lock(&TaskNamesCriticalSection);
+			if (const uint32* EventType = TaskNames.Find((uint64)Task))
+				return *EventType;
+		}
+		static const uint32 UnnamedEventType = FCpuProfilerTrace::OutputEventType(TEXT("CoroTask"));
+		return UnnamedEventType;
+	}
+}
+
+void Trace::OnFrameAllocated(SIZE_T Size)
+{
+	PendingFrameSize = (uint32)Size;
+}
+
+void Trace::OnCreate(const void* Task)
+{
+	UE_TRACE_LOG(CoroTasks, TaskCreate, CoroTasksChannel)
+		<< TaskCreate.Cycle(FPlatformTime::Cycles64())
+		<< TaskCreate.TaskId((uint64)Task)
+		<< TaskCreate.ParentId((uint64)CurrentTask)
+		<< TaskCreate.FrameSize(PendingFrameSize);
+	PendingFrameSize = 0;
+}
+
+void Trace::OnLaunch(const void* Task)
+{
+	UE_TRACE_LOG(CoroTasks, TaskLaunch, CoroTasksChannel)
+		<< TaskLaunch.Cycle(FPlatformTime::Cycles64())
+		<< TaskLaunch.TaskId((uint64)Task);
+}
+
+void Trace::OnSuspend(const void* Task, const TCHAR* AwaitableType)
+{
+	UE_TRACE_LOG(CoroTasks, TaskSuspend, CoroTasksChannel)
+		<< TaskSuspend.Cycle(FPlatformTime::Cycles64())
+		<< TaskSuspend.TaskId((uint64)Task)
+		<< TaskSuspend.AwaitableType(AwaitableType, FCString::Strlen(AwaitableType));
+	if (CurrentTask == Task)
+		CurrentTask = nullptr;
+}
+
+void Trace::OnResume(const void* Task)
+{
+	UE_TRACE_LOG(CoroTasks, TaskResume, CoroTasksChannel)
+		<< TaskResume.Cycle(FPlatformTime::Cycles64())
+		<< TaskResume.TaskId((uint64)Task);
+	CurrentTask = Task;
+}
+
+void Trace::OnComplete(const void* Task)
+{
+	UE_TRACE_LOG(CoroTasks, TaskComplete, CoroTasksChannel)
+		<< TaskComplete.Cycle(FPlatformTime::Cycles64())
+		<< TaskComplete.TaskId((uint64)Task);
+	if (CurrentTask == Task)
+		CurrentTask = nullptr;
+}
+
+void Trace::OnDestroy(const void* Task)
+{
+	UE_TRACE_LOG(CoroTasks, TaskDestroy, CoroTasksChannel)
+		<< TaskDestroy.Cycle(FPlatformTime::Cycles64())
+		<< TaskDestroy.TaskId((uint64)Task);
+
+	// Frame address can be reused by the next task
+	FScopeLock Lock(&TaskNamesCriticalSection);
+	TaskNames.Remove((uint64)Task);
+}
+
+void Trace::SetName(const void* Task, const TCHAR* Name)
+{
+	UE_TRACE_LOG(CoroTasks, TaskName, CoroTasksChannel)
+		<< TaskName.TaskId((uint64)Task)
+		<< TaskName.Name(Name, FCString::Strlen(Name));
+
+	FScopeLock Lock(&TaskNamesCriticalSection);
+	uint32* EventType = EventTypes.Find(Name);
+	if (EventType == nullptr)
+		EventType = &EventTypes.Add(Name, FCpuProfilerTrace::OutputEventType(Name));
+	TaskNames.Add((uint64)Task, *EventType);
+}
+
+void Trace::FResumeScope::Begin(const void* Task)
+{
+	PreviousTask = CurrentTask;
+	bCpuScope = UE_TRACE_CHANNELEXPR_IS_ENABLED(CpuChannel);
+	if (bCpuScope)
+		FCpuProfilerTrace::OutputBeginEvent(GetTaskEventType(Task));
+	OnResume(Task);
+}
+
+void Trace::FResumeScope::End()
+{
+	if (bCpuScope)
+		FCpuProfilerTrace::OutputEndEvent();
+	CurrentTask = PreviousTask;
+}
+
+#endif
@@ -0,0 +1,139 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "CoroSupport.h"
+
+#ifndef COROTASKS_TRACE_ENABLED
+	#define COROTASKS_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+#endif
+
+/**
+ * Tour to tracing:
+ * Task lifecycle is written to "CoroTasks" trace channel: create, launch, suspend (with awaitable type),
+ * resume, complete and destroy. Every event carries task id (address of coroutine frame), creation events
+ * also carry parent task id and frame size.
+ * Resumes that come from outside of coroutines (futures, primitives, Launch) are shown as CPU scopes named after the task.
+ * When the channel is off each hook is a single branch, in builds without trace it's compiled out.
+ *
+ * Enable it with "-trace=cpu,corotasks" or "Trace.Enable CoroTasks" and name your flows to see them in Insights:
+ *	>>> CoroTasks::TTask<> BuyCar(TSoftObjectPtr<UCar> CarAsset)
+ *	>>> {
+ *	>>>		co_await CoroTasks::TraceName(TEXT("BuyCar"));
+ *	>>>		...
+ *	>>> }
+ */
+#if COROTASKS_TRACE_ENABLED
+
+COROTASKS_API UE_TRACE_CHANNEL_EXTERN(CoroTasksChannel);
+
+namespace CoroTasks::Trace
+{
+	COROTASKS_API void OnFrameAllocated(SIZE_T Size);
+	COROTASKS_API void OnCreate(const void* Task);
+	COROTASKS_API void OnLaunch(const void* Task);
+	COROTASKS_API void OnSuspend(const void* Task, const TCHAR* AwaitableType);
+	COROTASKS_API void OnResume(const void* Task);
+	COROTASKS_API void OnComplete(const void* Task);
+	COROTASKS_API void OnDestroy(const void* Task);
+	COROTASKS_API void SetName(const void* Task, const TCHAR* Name);
+
+	/** Marks outermost resume of a task: CPU scope named after the task and parent for tasks created inside */
+	class FResumeScope
+	{
+	public:
+		explicit FResumeScope(const void* Task)
+			: bActive(UE_TRACE_CHANNELEXPR_IS_ENABLED(CoroTasksChannel))
+		{
+			if (bActive)
+				Begin(Task);
+		}
+
+		~FResumeScope()
+		{
+			if (bActive)
+				End();
+		}
+
+	private:
+		COROTASKS_API void Begin(const void* Task);
+		COROTASKS_API void End();
+
+		const void* PreviousTask;
+		bool bCpuScope;
+		bool bActive;
+	};
+}
+
+#define COROTASKS_TRACE(Event, ...) \
+	do \
+	{ \
+		if (UE_TRACE_CHANNELEXPR_IS_ENABLED(CoroTasksChannel)) \
+			CoroTasks::Trace::Event(__VA_ARGS__); \
+	} while (0)
+
+#define COROTASKS_TRACE_RESUME_SCOPE(Task) \
+	CoroTasks::Trace::FResumeScope PREPROCESSOR_JOIN(CoroTasksResumeScope, __LINE__)(Task)
+
+#else
+
+#define COROTASKS_TRACE(Event, ...)
+#define COROTASKS_TRACE_RESUME_SCOPE(Task)
+
+#endif
+
+namespace CoroTasks
+{
+	/** Names the awaiting task in trace. Never suspends and does nothing when trace is off */
+	struct FTraceNameAwaiter
+	{
+		bool await_ready() const noexcept
+		{
+#if COROTASKS_TRACE_ENABLED
+			return !UE_TRACE_CHANNELEXPR_IS_ENABLED(CoroTasksChannel);
+#else
+			return true;
+#endif
+		}
+
+		bool await_suspend(std::coroutine_handle<> Handle) const noexcept
+		{
+			COROTASKS_TRACE(SetName, Handle.address(), Name);
+			return false;
+		}
+
+		void await_resume() const noexcept
+		{
+		}
+
+		const TCHAR* Name;
+	};
+
+	inline FTraceNameAwaiter TraceName(const TCHAR* Name)
+	{
+		return FTraceNameAwaiter{Name};
+	}
+}
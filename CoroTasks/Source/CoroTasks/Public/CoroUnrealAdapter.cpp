@@ -0,0 +1,63 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroUnrealAdapter.h"
+
+namespace
+{
+	/** Resumes queued to the game thread by ticket. A cancelled frame removes its tickets, so its queued resumes do nothing */
+	FCriticalSection QueuedResumesLock;
+	TMap<uint64, void*> QueuedResumes;
+	uint64 LastTicket = 0;
+}
+
+void CoroTasks::Core::ResumeOnMainThread(std::coroutine_handle<> Handle)
+{
+	uint64 Ticket = 0;
+	{
+		FScopeLock Lock(&QueuedResumesLock);
+		Ticket = ++LastTicket;
+		QueuedResumes.Add(Ticket, Handle.address());
+	}
+
+	AsyncTask(ENamedThreads::GameThread, [Handle, Ticket]
+	{
+		{
+			FScopeLock Lock(&QueuedResumesLock);
+			if (QueuedResumes.Remove(Ticket) == 0)
+				return;
+		}
+		COROTASKS_TRACE_RESUME_SCOPE(Handle.address());
+		Handle.resume();
+	});
+}
+
+void CoroTasks::Core::ForgetMainThreadResumes(void* FrameAddress)
+{
+	FScopeLock Lock(&QueuedResumesLock);
+	for (auto It = QueuedResumes.CreateIterator(); It; ++It)
+	{
+		if (It.Value() == FrameAddress)
+			It.RemoveCurrent();
+	}
+}
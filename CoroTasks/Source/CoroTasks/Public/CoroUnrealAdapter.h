@@ -0,0 +1,67 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Async.h"
+#include "AsyncException.h"
+#include "CoroSupport.h"
+#include "CoroFramePool.h"
+#include "CoroTrace.h"
+#include "CoroRegistry.h"
+#include "CoroAwaitLatency.h"
+
+/** Unreal adapter of the engine-independent core (see Core/CoroCoreConfig.h) */
+
+#define COROTASKS_CHECK(Expr) check(Expr)
+#define COROTASKS_ENSURE(Expr, Message) ensureMsgf(Expr, TEXT("%hs"), Message)
+#define COROTASKS_TEXT(Literal) TEXT(Literal)
+
+struct FCoroError : FAsyncException
+{
+	FCoroError(const FString& Message)
+		: FAsyncException(Message)
+	{}
+};
+
+namespace CoroTasks
+{
+	using ::FCoroError;
+
+	namespace Core
+	{
+		using FAwaitableName = const TCHAR*;
+
+		inline bool IsInMainThread()
+		{
+			return IsInGameThread();
+		}
+
+		/** Queues the resume to the game thread, it's dropped if the frame is cancelled before the resume runs */
+		COROTASKS_API void ResumeOnMainThread(std::coroutine_handle<> Handle);
+
+		/** Called on the game thread when a suspended frame is destroyed */
+		COROTASKS_API void ForgetMainThreadResumes(void* FrameAddress);
+	}
+}
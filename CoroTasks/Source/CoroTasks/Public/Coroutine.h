@@ -27,23 +27,55 @@
 #include "CoroSupport.h"
 
 
+namespace CoroTasks
+{
+	/** Keeps the shared future alive while it's awaited. Awaiter is declared after the reference, so it's destroyed first */
+	template<typename T>
+	struct TSharedFutureAwaiter
+	{
+		explicit TSharedFutureAwaiter(TSharedRef<TFuture<T>>&& InFuture)
+			: Future(MoveTemp(InFuture))
+			, Awaiter(Future.Get())
+		{}
+
+		bool await_ready()
+		{
+			return Awaiter.await_ready();
+		}
+
+		template<typename PromiseType>
+		void await_suspend(std::coroutine_handle<PromiseType> Continuation)
+		{
+			Awaiter.await_suspend(Continuation);
+		}
+
+		decltype(auto) await_resume()
+		{
+			return Awaiter.await_resume();
+		}
+
+		TSharedRef<TFuture<T>> Future;
+		TFutureAwaiter<TFuture<T>> Awaiter;
+	};
+}
+
 template<typename T>
-CoroTasks::TFuture<T>& operator co_await(TSharedRef<CoroTasks::TFuture<T>> InSharedRef)
+CoroTasks::TSharedFutureAwaiter<T> operator co_await(TSharedRef<CoroTasks::TFuture<T>> InSharedRef)
 {
-	return InSharedRef.Get();
+	return CoroTasks::TSharedFutureAwaiter<T>(MoveTemp(InSharedRef));
 }
 
 
 template<typename T>
 auto operator co_await(const TObjectPtr<T>& ObjectPtr) ->
-	decltype(ObjectPtr->operator co_await())&
+	decltype(ObjectPtr->operator co_await())
 {
 	return ObjectPtr->operator co_await();
 }
 
 template<typename T>
 auto operator co_await(const TWeakObjectPtr<T>& ObjectPtr) ->
-	decltype(ObjectPtr->operator co_await())&
+	decltype(ObjectPtr->operator co_await())
 {
 	return ObjectPtr->operator co_await();
 }
\ No newline at end of file
@@ -0,0 +1,218 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroutineComponent.h"
+#include "CoroTasks.h"
+#include "Engine/World.h"
+
+using namespace CoroTasks;
+
+FComponentTickAwaiter::FComponentTickAwaiter(UCoroutineComponent* InComponent, double InDeadline, TFunction<bool()>&& InPredicate)
+	: Component(InComponent)
+	, Predicate(MoveTemp(InPredicate))
+	, Deadline(InDeadline)
+	, DeltaTime(0.f)
+	, bWaiting(false)
+{}
+
+FComponentTickAwaiter::~FComponentTickAwaiter()
+{
+	if (!bWaiting)
+		return;
+
+	if (UCoroutineComponent* ComponentPtr = Component.Get(true))
+		ComponentPtr->RemoveWaiter(this);
+}
+
+bool FComponentTickAwaiter::await_ready()
+{
+	// Nothing would resume us
+	UCoroutineComponent* ComponentPtr = Component.Get();
+	if (!ComponentPtr || ComponentPtr->bEndedPlay)
+		return true;
+
+	return Predicate && Predicate();
+}
+
+void FComponentTickAwaiter::await_suspend(std::coroutine_handle<> Handle)
+{
+	Continuation = FContinuation::Capture(Handle, TEXT("FComponentTickAwaiter"));
+	bWaiting = true;
+	Component->AddWaiter(this);
+}
+
+bool FComponentTickAwaiter::IsReady(double Time) const
+{
+	if (Predicate)
+		return Predicate();
+	return Time >= Deadline;
+}
+
+
+UCoroutineComponent::UCoroutineComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UCoroutineComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	bEndedPlay = false;
+}
+
+void UCoroutineComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	bEndedPlay = true;
+	CancelAll();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UCoroutineComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
+{
+	bEndedPlay = true;
+	CancelAll();
+	Super::OnComponentDestroyed(bDestroyingHierarchy);
+}
+
+void UCoroutineComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const double Time = GetWorld()->GetTimeSeconds();
+	Waiters.RemoveAll([this, Time, DeltaTime](FComponentTickAwaiter* Waiter)
+	{
+		if (!Waiter->IsReady(Time))
+			return false;
+
+		Waiter->DeltaTime = DeltaTime;
+		Resuming.Add(Waiter);
+		return true;
+	});
+
+	// Resumed coroutines may wait again (next tick) or destroy other waiters of this tick
+	++ResumeDepth;
+	for (int32 Index = 0; Index < Resuming.Num(); ++Index)
+	{
+		if (FComponentTickAwaiter* Waiter = Resuming[Index])
+		{
+			Resuming[Index] = nullptr;
+			Waiter->bWaiting = false;
+			Waiter->Continuation.Resume();
+		}
+	}
+	Resuming.Reset();
+	--ResumeDepth;
+
+	FinishResume();
+	Tasks.RemoveAll([](const TTask<>& Task) { return Task.IsDone(); });
+	if (Waiters.IsEmpty())
+		SetComponentTickEnabled(false);
+}
+
+void UCoroutineComponent::Run(TTask<>&& Task)
+{
+	if (bEndedPlay)
+	{
+		UE_LOG(LogCoroTasks, Warning, TEXT("Coroutine isn't started on %s: component has ended play"), *GetPathName());
+		return;
+	}
+
+	// Launched before it's added, so nested Run calls can't move it while it runs
+	TTask<> Launched = MoveTemp(Task);
+	++ResumeDepth;
+	Launched.Launch();
+	--ResumeDepth;
+
+	// Coroutines that finished outside of our tick would pile up until the next one
+	Tasks.RemoveAll([](const TTask<>& Task) { return Task.IsDone(); });
+	if (!Launched.IsDone())
+		Tasks.Add(MoveTemp(Launched));
+	FinishResume();
+}
+
+void UCoroutineComponent::CancelAll()
+{
+	if (ResumeDepth > 0)
+	{
+		bCancelPending = true;
+		return;
+	}
+
+	// Cancelled frames may start new coroutines from destructors of their locals
+	TArray<TTask<>> Cancelled = MoveTemp(Tasks);
+	for (TTask<>& Task : Cancelled)
+		Task.Cancel();
+}
+
+int32 UCoroutineComponent::GetNumRunning() const
+{
+	int32 Count = 0;
+	for (const TTask<>& Task : Tasks)
+		Count += Task.IsDone() ? 0 : 1;
+	return Count;
+}
+
+FComponentTickAwaiter UCoroutineComponent::NextTick()
+{
+	return FComponentTickAwaiter(this, -1.0, nullptr);
+}
+
+FComponentTickAwaiter UCoroutineComponent::Wait(float Seconds)
+{
+	const UWorld* World = GetWorld();
+	return FComponentTickAwaiter(this, (World ? World->GetTimeSeconds() : 0.0) + Seconds, nullptr);
+}
+
+FComponentTickAwaiter UCoroutineComponent::WaitUntil(TFunction<bool()> Predicate)
+{
+	check(Predicate);
+	return FComponentTickAwaiter(this, -1.0, MoveTemp(Predicate));
+}
+
+void UCoroutineComponent::AddWaiter(FComponentTickAwaiter* Waiter)
+{
+	Waiters.Add(Waiter);
+	if (!IsComponentTickEnabled())
+		SetComponentTickEnabled(true);
+}
+
+void UCoroutineComponent::RemoveWaiter(FComponentTickAwaiter* Waiter)
+{
+	if (Waiters.RemoveSingle(Waiter) == 0)
+	{
+		const int32 Index = Resuming.Find(Waiter);
+		if (Index != INDEX_NONE)
+			Resuming[Index] = nullptr;
+	}
+}
+
+void UCoroutineComponent::FinishResume()
+{
+	if (ResumeDepth == 0 && bCancelPending)
+	{
+		bCancelPending = false;
+		CancelAll();
+	}
+}
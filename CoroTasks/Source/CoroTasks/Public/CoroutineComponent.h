@@ -0,0 +1,147 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CoroTask.h"
+#include "CoroutineComponent.generated.h"
+
+class UCoroutineComponent;
+
+namespace CoroTasks
+{
+	/** Suspends until a tick of UCoroutineComponent that satisfies the wait. Returns DeltaTime of that tick (0 if not suspended) */
+	class COROTASKS_API FComponentTickAwaiter
+	{
+	public:
+		FComponentTickAwaiter(UCoroutineComponent* InComponent, double InDeadline, TFunction<bool()>&& InPredicate);
+
+		/** Lives in the awaiting frame and is bound by address */
+		FComponentTickAwaiter(const FComponentTickAwaiter&) = delete;
+		FComponentTickAwaiter& operator=(const FComponentTickAwaiter&) = delete;
+
+		/** Coroutine destroyed while waiting: component forgets the wait */
+		~FComponentTickAwaiter();
+
+		bool await_ready();
+		void await_suspend(std::coroutine_handle<> Handle);
+
+		float await_resume() const
+		{
+			return DeltaTime;
+		}
+
+	private:
+		friend UCoroutineComponent;
+
+		bool IsReady(double Time) const;
+
+		TWeakObjectPtr<UCoroutineComponent> Component;
+		TFunction<bool()> Predicate;
+		/** World time to resume at, negative for the next tick */
+		double Deadline;
+		FContinuation Continuation;
+		float DeltaTime;
+		bool bWaiting;
+	};
+}
+
+/**
+ * Tour to coroutine component:
+ * Hosts coroutines owned by an actor, so timed sequences don't need TickComponent state machines.
+ * Tick of the component is enabled only while some coroutine waits for it, idle actors cost no tick time.
+ * Waits resume in the component's tick group (PrimaryComponentTick.TickGroup, "Tick Group" in details panel).
+ * On EndPlay (or destruction without play) all running coroutines are cancelled: frames are destroyed with their locals and pending awaiters.
+ * Await NextTick, Wait and WaitUntil only from coroutines this component runs: a foreign coroutine isn't resumed after EndPlay.
+ * Destroying the owner from inside of a coroutine is fine when it was resumed by this component (cancel is deferred until it suspends),
+ * coroutines resumed by something else should not destroy their owner synchronously
+ *
+ * Use case:
+ *	>>> Coroutines->Run(OpenDoor());
+ *
+ *	>>> CoroTasks::TTask<> ADoor::OpenDoor()
+ *	>>> {
+ *	>>>		while (Angle < 90.f)
+ *	>>>			Angle += Speed * co_await Coroutines->NextTick();
+ *	>>>		co_await Coroutines->Wait(AutoCloseDelay);
+ *	>>>		co_await Coroutines->WaitUntil([this] { return Overlapping.IsEmpty(); });
+ *	>>>		...
+ *	>>> }
+ */
+UCLASS(ClassGroup=(CoroTasks), meta=(BlueprintSpawnableComponent))
+class COROTASKS_API UCoroutineComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UCoroutineComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	// BEGIN UActorComponent
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// END UActorComponent
+
+	/** Launches the task and keeps it until it finishes or is cancelled. Tasks aren't started after EndPlay */
+	void Run(CoroTasks::TTask<>&& Task);
+
+	/** Cancels every running coroutine, deferred until the resumed one suspends if called from inside of it */
+	void CancelAll();
+
+	int32 GetNumRunning() const;
+
+	/** Resumes on the next tick of this component */
+	CoroTasks::FComponentTickAwaiter NextTick();
+
+	/** Resumes on the first tick after Seconds of world time (dilated, paused with the world) */
+	CoroTasks::FComponentTickAwaiter Wait(float Seconds);
+
+	/** Resumes on the first tick where Predicate returns true, doesn't suspend if it's true already */
+	CoroTasks::FComponentTickAwaiter WaitUntil(TFunction<bool()> Predicate);
+
+private:
+	friend CoroTasks::FComponentTickAwaiter;
+
+	void AddWaiter(CoroTasks::FComponentTickAwaiter* Waiter);
+	void RemoveWaiter(CoroTasks::FComponentTickAwaiter* Waiter);
+
+	/** Runs deferred cancel once no coroutine is being resumed by this component */
+	void FinishResume();
+
+	TArray<CoroTasks::TTask<>> Tasks;
+
+	/** In order of waiting */
+	TArray<CoroTasks::FComponentTickAwaiter*> Waiters;
+
+	/** Waiters of the current tick, destroyed ones are nulled */
+	TArray<CoroTasks::FComponentTickAwaiter*> Resuming;
+
+	int32 ResumeDepth = 0;
+
+	bool bCancelPending = false;
+
+	bool bEndedPlay = false;
+};
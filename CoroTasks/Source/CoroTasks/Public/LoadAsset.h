@@ -62,6 +62,7 @@ namespace CoroTasks
 				check(SoftObjectPtr.Get()->template IsA<T>());
 			Future->SetResult((T*)(SoftObjectPtr.Get()));
 		};
+		COROTASKS_REGISTRY(Future->RegistryNode.Describe(TEXT("LoadSingleObject"), FName(*SoftObjectPtr.ToString())));
 		Private::RequestAsyncLoad({SoftObjectPtr.ToSoftObjectPath()}, MoveTempIfPossible(Lambda), OptionalContext);
 		return Future;
 	}
@@ -78,6 +79,7 @@ namespace CoroTasks
 		};
 		TArray<FSoftObjectPath> ObjectPaths;
 		Algo::Transform(SoftObjects, ObjectPaths, &TSoftObjectPtr<T>::ToSoftObjectPath);
+		COROTASKS_REGISTRY(Future->RegistryNode.Describe(TEXT("LoadMultipleObjects"), ObjectPaths.Num() > 0 ? FName(*ObjectPaths[0].ToString()) : NAME_None));
 		Private::RequestAsyncLoad(ObjectPaths, MoveTempIfPossible(Lambda), OptionalContext);
 		return Future;
 	}
@@ -92,6 +94,7 @@ namespace CoroTasks
 			Future->SetResult(TSubclassOf<T>(SoftClassPtr.Get()));
 		};
 
+		COROTASKS_REGISTRY(Future->RegistryNode.Describe(TEXT("LoadSingleClass"), FName(*SoftClassPtr.ToString())));
 		Private::RequestAsyncLoad({SoftClassPtr.ToSoftObjectPath()}, MoveTempIfPossible(Lambda), OptionalContext);
 
 		return Future;
@@ -0,0 +1,289 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "CoroScheduler.h"
+#include "CoroTask.h"
+#include "Tasks/Task.h"
+
+/**
+ * Tour to engine tasks interop:
+ * Coroutines can await engine tasks without polling, the awaiting coroutine is resumed by the completion itself
+ *	1. UE::Tasks::TTask<T>	- co_await returns the task result
+ *	2. FGraphEventRef		- co_await returns nothing
+ *	3. TFuture<T>			- engine future from Async/Future.h (not CoroTasks::TFuture), it's consumed by co_await
+ * Coroutine that was suspended on the game thread continues on the game thread, otherwise it continues
+ * on the thread that completed the awaited work.
+ * Cost of a suspension: neither the tasks system nor the task graph can call back on completion, so every suspended
+ * co_await of a task or a graph event creates one small engine task (futures use their own continuation, TFuture::Then)
+ *	- UE::Tasks::TTask	- inline task, runs right where the awaited task completes, no extra scheduling
+ *	- FGraphEventRef	- fire-and-forget graph task, the task graph has no inline mode: a coroutine that doesn't need
+ *						  the game thread continues on a high priority worker, not on the completing thread
+ * Only a coroutine suspended on the game thread and completed elsewhere pays for a hop to the game thread.
+ *
+ * >>> int32 Count = co_await UE::Tasks::Launch(UE_SOURCE_LOCATION, [] { return CountEntries(); });
+ * >>> co_await MeshBuildEvent;
+ * >>> FString Response = co_await MoveTemp(HttpFuture);
+ *
+ * In the other direction, a coroutine task becomes a prerequisite of engine tasks
+ * >>> UE::Tasks::FTaskEvent Loaded = CoroTasks::AsPrerequisite(LoadConfig());
+ * >>> UE::Tasks::Launch(UE_SOURCE_LOCATION, [] { ApplyConfig(); }, UE::Tasks::Prerequisites(Loaded));
+ */
+namespace CoroTasks
+{
+	namespace Private
+	{
+		using FSharedContinuation = TSharedRef<FRevocableContinuation, ESPMode::ThreadSafe>;
+
+		/** Runs inline on the completing thread, the continuation itself hops to the game thread if it has to */
+		template<typename TaskType>
+		void ResumeWhenCompleted(const FSharedContinuation& Continuation, const TaskType& Prerequisite)
+		{
+			UE::Tasks::Launch(TEXT("CoroTasks::Resume"), [Continuation] { Continuation->Resume(); }, UE::Tasks::Prerequisites(Prerequisite),
+				UE::Tasks::ETaskPriority::Normal, UE::Tasks::EExtendedTaskPriority::Inline);
+		}
+
+		/** Graph task without a completion event of its own, it only resumes the awaiting coroutine */
+		class FResumeGraphTask
+		{
+		public:
+			FResumeGraphTask(const FSharedContinuation& InContinuation, ENamedThreads::Type InDesiredThread)
+				: Continuation(InContinuation)
+				, DesiredThread(InDesiredThread)
+			{}
+
+			TStatId GetStatId() const
+			{
+				RETURN_QUICK_DECLARE_CYCLE_STAT(FResumeGraphTask, STATGROUP_TaskGraphTasks);
+			}
+
+			ENamedThreads::Type GetDesiredThread() const
+			{
+				return DesiredThread;
+			}
+
+			static ESubsequentsMode::Type GetSubsequentsMode()
+			{
+				return ESubsequentsMode::FireAndForget;
+			}
+
+			void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& CompletionGraphEvent)
+			{
+				Continuation->Resume();
+			}
+
+		private:
+			FSharedContinuation Continuation;
+			ENamedThreads::Type DesiredThread;
+		};
+
+		/**
+		 * Completions of engine tasks, graph events and futures can't be unsubscribed, so they resume through a continuation
+		 * shared with the awaiter. Destroyed (cancelled) awaiter revokes it and the completion does nothing
+		 */
+		template<typename T>
+		struct TEngineTaskAwaiter
+		{
+			UE::Tasks::TTask<T> Task;
+			TSharedPtr<FRevocableContinuation, ESPMode::ThreadSafe> Continuation;
+
+			~TEngineTaskAwaiter()
+			{
+				if (Continuation)
+					Continuation->Revoke();
+			}
+
+			bool await_ready() const
+			{
+				return Task.IsCompleted();
+			}
+
+			void await_suspend(std::coroutine_handle<> Handle)
+			{
+				Continuation = MakeShared<FRevocableContinuation, ESPMode::ThreadSafe>(FContinuation::Capture(Handle, TEXT("UE::Tasks::TTask")));
+				ResumeWhenCompleted(Continuation.ToSharedRef(), Task);
+			}
+
+			T await_resume()
+			{
+				if constexpr (!std::is_void_v<T>)
+					return Task.GetResult();
+			}
+		};
+
+		struct FGraphEventAwaiter
+		{
+			FGraphEventRef Event;
+			TSharedPtr<FRevocableContinuation, ESPMode::ThreadSafe> Continuation;
+
+			~FGraphEventAwaiter()
+			{
+				if (Continuation)
+					Continuation->Revoke();
+			}
+
+			bool await_ready() const
+			{
+				return !Event.IsValid() || Event->IsComplete();
+			}
+
+			void await_suspend(std::coroutine_handle<> Handle)
+			{
+				const FContinuation Captured = FContinuation::Capture(Handle, TEXT("FGraphEvent"));
+				Continuation = MakeShared<FRevocableContinuation, ESPMode::ThreadSafe>(Captured);
+				FGraphEventArray Prerequisites{Event};
+				TGraphTask<FResumeGraphTask>::CreateTask(&Prerequisites).ConstructAndDispatchWhenReady(Continuation.ToSharedRef(),
+					Captured.bGameThread ? ENamedThreads::GameThread : ENamedThreads::AnyHiPriThreadHiPriTask);
+			}
+
+			void await_resume()
+			{
+			}
+		};
+
+		/** Future continuation stores the value in the state it shares with the awaiter, the awaiter takes it on resume */
+		template<typename T>
+		struct TEngineFutureAwaiter
+		{
+			struct FState : FRevocableContinuation
+			{
+				using FRevocableContinuation::FRevocableContinuation;
+				TOptional<T> Result;
+			};
+
+			::TFuture<T> Future;
+			TSharedPtr<FState, ESPMode::ThreadSafe> State;
+
+			~TEngineFutureAwaiter()
+			{
+				if (State)
+					State->Revoke();
+			}
+
+			bool await_ready() const
+			{
+				return Future.IsReady();
+			}
+
+			void await_suspend(std::coroutine_handle<> Handle)
+			{
+				State = MakeShared<FState, ESPMode::ThreadSafe>(FContinuation::Capture(Handle, TEXT("TFuture")));
+				Future.Then([Shared = State.ToSharedRef()] (::TFuture<T> ReadyFuture)
+				{
+					Shared->Result.Emplace(ReadyFuture.Consume());
+					Shared->Resume();
+				});
+			}
+
+			T await_resume()
+			{
+				if (State && State->Result.IsSet())
+					return MoveTemp(*State->Result);
+				return Future.Consume();
+			}
+		};
+
+		template<>
+		struct TEngineFutureAwaiter<void>
+		{
+			::TFuture<void> Future;
+			TSharedPtr<FRevocableContinuation, ESPMode::ThreadSafe> Continuation;
+
+			~TEngineFutureAwaiter()
+			{
+				if (Continuation)
+					Continuation->Revoke();
+			}
+
+			bool await_ready() const
+			{
+				return Future.IsReady();
+			}
+
+			void await_suspend(std::coroutine_handle<> Handle)
+			{
+				Continuation = MakeShared<FRevocableContinuation, ESPMode::ThreadSafe>(FContinuation::Capture(Handle, TEXT("TFuture")));
+				Future.Then([Shared = Continuation.ToSharedRef()] (::TFuture<void>)
+				{
+					Shared->Resume();
+				});
+			}
+
+			void await_resume()
+			{
+			}
+		};
+
+		template<typename R>
+		TTask<> TriggerWhenFinished(TTask<R> Task, UE::Tasks::FTaskEvent Event)
+		{
+#if COROTASKS_WITH_EXCEPTIONS
+			try
+			{
+				co_await MoveTemp(Task);
+			}
+			catch (...)
+			{
+				// Prerequisite carries completion only, errors stay with whoever awaits the result
+			}
+#else
+			auto Result = co_await MoveTemp(Task);
+#endif
+			Event.Trigger();
+		}
+	}
+
+	/** Launches the task (if it's not launched yet) and returns event triggered when it finishes. Result of the task is dropped */
+	template<typename R>
+	UE::Tasks::FTaskEvent AsPrerequisite(TTask<R>&& Task)
+	{
+		UE::Tasks::FTaskEvent Event(TEXT("CoroTasks::TTask"));
+		Private::TriggerWhenFinished(MoveTemp(Task), Event).Launch();
+		return Event;
+	}
+}
+
+namespace UE::Tasks
+{
+	/** Declared in the namespace of the task, so argument-dependent lookup finds it from any coroutine */
+	template<typename T>
+	CoroTasks::Private::TEngineTaskAwaiter<T> operator co_await(TTask<T> Task)
+	{
+		return {MoveTemp(Task)};
+	}
+}
+
+inline CoroTasks::Private::FGraphEventAwaiter operator co_await(FGraphEventRef Event)
+{
+	return {MoveTemp(Event)};
+}
+
+template<typename T>
+CoroTasks::Private::TEngineFutureAwaiter<T> operator co_await(TFuture<T>&& Future)
+{
+	return {MoveTemp(Future)};
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "CoroBench.h"
+
+namespace
+{
+	struct FResult
+	{
+		std::string Name;
+		int64_t Iterations;
+		double NsPerOp;
+	};
+
+	/** Doubles iterations until the run takes at least MinTime, like Google Benchmark does */
+	FResult Run(const CoroBench::FBenchmark& Benchmark, int64_t Arg, bool bHasArg, double MinTime)
+	{
+		int64_t Iterations = 1;
+		for (;;)
+		{
+			CoroBench::FState State(Iterations, Arg);
+			Benchmark.Function(State);
+			const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - State.StartTime).count();
+			if (Seconds >= MinTime || Iterations >= (int64_t(1) << 40))
+			{
+				std::string Name = Benchmark.Name;
+				if (bHasArg)
+					Name += "/" + std::to_string(Arg);
+				return {Name, Iterations, Seconds * 1e9 / (double)Iterations};
+			}
+			Iterations *= 2;
+		}
+	}
+}
+
+/**
+ * Arguments:
+ *	--filter=Substring		- runs only matching benchmarks
+ *	--min-time=Seconds		- minimal duration of each benchmark, 0.5 by default
+ *	--json=Path				- writes results in Google Benchmark JSON format
+ */
+int main(int Argc, char** Argv)
+{
+	const char* Filter = nullptr;
+	const char* JsonPath = nullptr;
+	double MinTime = 0.5;
+	for (int Index = 1; Index < Argc; ++Index)
+	{
+		if (!std::strncmp(Argv[Index], "--filter=", 9))
+			Filter = Argv[Index] + 9;
+		else if (!std::strncmp(Argv[Index], "--min-time=", 11))
+			MinTime = std::atof(Argv[Index] + 11);
+		else if (!std::strncmp(Argv[Index], "--json=", 7))
+			JsonPath = Argv[Index] + 7;
+	}
+
+	std::vector<FResult> Results;
+	std::printf("%-40s %14s %14s\n", "Benchmark", "Time (ns)", "Iterations");
+	for (const CoroBench::FBenchmark* Benchmark : CoroBench::GetBenchmarks())
+	{
+		if (Filter && !std::strstr(Benchmark->Name, Filter))
+			continue;
+
+		const bool bHasArgs = !Benchmark->Args.empty();
+		const std::vector<int64_t> Args = bHasArgs ? Benchmark->Args : std::vector<int64_t>{0};
+		for (int64_t Arg : Args)
+		{
+			const FResult& Result = Results.emplace_back(Run(*Benchmark, Arg, bHasArgs, MinTime));
+			std::printf("%-40s %14.2f %14lld\n", Result.Name.c_str(), Result.NsPerOp, (long long)Result.Iterations);
+		}
+	}
+
+	if (JsonPath)
+	{
+		FILE* File = std::fopen(JsonPath, "w");
+		if (!File)
+		{
+			std::fprintf(stderr, "Can't write %s\n", JsonPath);
+			return 1;
+		}
+		std::fprintf(File, "{\n  \"benchmarks\": [\n");
+		for (size_t Index = 0; Index < Results.size(); ++Index)
+		{
+			const FResult& Result = Results[Index];
+			std::fprintf(File, "    {\"name\": \"%s\", \"iterations\": %lld, \"real_time\": %.3f, \"time_unit\": \"ns\"}%s\n",
+				Result.Name.c_str(), (long long)Result.Iterations, Result.NsPerOp, Index + 1 < Results.size() ? "," : "");
+		}
+		std::fprintf(File, "  ]\n}\n");
+		std::fclose(File);
+	}
+	return 0;
+}
@@ -0,0 +1,126 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstdlib>
+
+#include "CoroBench.h"
+#include "CoroFramePoolCore.h"
+#include "CoroFuture.h"
+#include "CoroTask.h"
+
+namespace
+{
+	CoroTasks::TTask<int> Task_Value(int Value)
+	{
+		co_return Value;
+	}
+
+	CoroTasks::TTask<int> Task_Chain(int Depth)
+	{
+		if (Depth == 0)
+			co_return 0;
+		CORO_TRY(Value, Task_Chain(Depth - 1));
+		co_return Value + 1;
+	}
+
+	CoroTasks::TTask<> Task_Await(CoroTasks::TFuture<int>& Future, int& Out)
+	{
+		Out = co_await Future;
+	}
+
+	void Task_CreateLaunchComplete(CoroBench::FState& State)
+	{
+		for (auto _ : State)
+		{
+			CoroTasks::TTask<int> Task = Task_Value(1);
+			Task.Launch();
+			CoroBench::DoNotOptimize(Task);
+		}
+	}
+
+	void Task_AwaitChain(CoroBench::FState& State)
+	{
+		const int Depth = (int)State.range(0);
+		for (auto _ : State)
+		{
+			CoroTasks::TTask<int> Task = Task_Chain(Depth);
+			Task.Launch();
+			CoroBench::DoNotOptimize(Task);
+		}
+	}
+
+	void Future_SetResultResume(CoroBench::FState& State)
+	{
+		int Out = 0;
+		for (auto _ : State)
+		{
+			CoroTasks::TFuture<int> Future;
+			CoroTasks::TTask<> Task = Task_Await(Future, Out);
+			Task.Launch();
+			Future.SetResult(1);
+		}
+		CoroBench::DoNotOptimize(Out);
+	}
+
+	struct FMallocAllocator
+	{
+		static void* Malloc(std::size_t Size)
+		{
+			return std::malloc(Size);
+		}
+
+		static void Free(void* Ptr)
+		{
+			std::free(Ptr);
+		}
+	};
+
+	void FramePool_AllocateFree(CoroBench::FState& State)
+	{
+		const std::size_t Size = (std::size_t)State.range(0);
+		for (auto _ : State)
+		{
+			void* Frame = CoroTasks::Core::TFramePool<FMallocAllocator>::Allocate(Size);
+			CoroBench::DoNotOptimize(Frame);
+			CoroTasks::Core::TFramePool<FMallocAllocator>::Free(Frame, Size);
+		}
+	}
+
+	/** Baseline for FramePool_AllocateFree */
+	void Malloc_AllocateFree(CoroBench::FState& State)
+	{
+		const std::size_t Size = (std::size_t)State.range(0);
+		for (auto _ : State)
+		{
+			void* Frame = std::malloc(Size);
+			CoroBench::DoNotOptimize(Frame);
+			std::free(Frame);
+		}
+	}
+}
+
+COROBENCH(Task_CreateLaunchComplete);
+COROBENCH(Task_AwaitChain)->Arg(1)->Arg(10)->Arg(100);
+COROBENCH(Future_SetResultResume);
+COROBENCH(FramePool_AllocateFree)->Arg(64)->Arg(256)->Arg(1024);
+COROBENCH(Malloc_AllocateFree)->Arg(64)->Arg(256)->Arg(1024);
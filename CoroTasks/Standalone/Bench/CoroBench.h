@@ -0,0 +1,156 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Micro benchmark harness of the standalone core build. It follows Google Benchmark conventions
+ * (state loop, argument ranges, DoNotOptimize, console and JSON reporters), so results are easy to compare,
+ * but doesn't require the library:
+ * >>> static void Task_Launch(CoroBench::FState& State)
+ * >>> {
+ * >>>		for (auto _ : State)
+ * >>>			CoroBench::DoNotOptimize(MakeTask());
+ * >>> }
+ * >>> COROBENCH(Task_Launch)->Arg(1)->Arg(100);
+ */
+namespace CoroBench
+{
+	class FState
+	{
+	public:
+		struct FIterator
+		{
+			int64_t Remaining;
+
+			bool operator!=(const FIterator&) const
+			{
+				return Remaining != 0;
+			}
+
+			FIterator& operator++()
+			{
+				--Remaining;
+				return *this;
+			}
+
+			/** Non-trivial, so `for (auto _ : State)` doesn't trigger unused variable warnings */
+			struct FValue
+			{
+				FValue() {}
+				~FValue() {}
+			};
+
+			FValue operator*() const
+			{
+				return {};
+			}
+		};
+
+		FState(int64_t InIterations, int64_t InArg)
+			: Iterations(InIterations)
+			, Argument(InArg)
+		{}
+
+		FIterator begin()
+		{
+			StartTime = std::chrono::steady_clock::now();
+			return {Iterations};
+		}
+
+		FIterator end()
+		{
+			return {0};
+		}
+
+		int64_t range(int Index = 0) const
+		{
+			return Index == 0 ? Argument : 0;
+		}
+
+		int64_t iterations() const
+		{
+			return Iterations;
+		}
+
+		std::chrono::steady_clock::time_point StartTime;
+		int64_t Iterations;
+		int64_t Argument;
+	};
+
+	using FBenchFunction = void(*)(FState&);
+
+	struct FBenchmark
+	{
+		const char* Name;
+		FBenchFunction Function;
+		std::vector<int64_t> Args;
+
+		FBenchmark* Arg(int64_t Value)
+		{
+			Args.push_back(Value);
+			return this;
+		}
+	};
+
+	inline std::vector<FBenchmark*>& GetBenchmarks()
+	{
+		static std::vector<FBenchmark*> Benchmarks;
+		return Benchmarks;
+	}
+
+	inline FBenchmark* Register(const char* Name, FBenchFunction Function)
+	{
+		FBenchmark* Benchmark = new FBenchmark{Name, Function, {}};
+		GetBenchmarks().push_back(Benchmark);
+		return Benchmark;
+	}
+
+	template<typename T>
+	inline void DoNotOptimize(T&& Value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(Value) : "memory");
+#else
+		static volatile const void* Sink;
+		Sink = &Value;
+#endif
+	}
+
+	inline void ClobberMemory()
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : : "memory");
+#endif
+	}
+}
+
+#define COROBENCH_JOIN_INNER(A, B) A##B
+#define COROBENCH_JOIN(A, B) COROBENCH_JOIN_INNER(A, B)
+
+#define COROBENCH(Function) \
+	static CoroBench::FBenchmark* COROBENCH_JOIN(CoroBenchRegister_, __LINE__) = CoroBench::Register(#Function, &Function)
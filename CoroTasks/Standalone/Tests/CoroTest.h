@@ -0,0 +1,82 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+/**
+ * Minimal test registry for the standalone core build, it's a tiny subset of automation tests:
+ * >>> COROTEST(Task_ReturnsValue)
+ * >>> {
+ * >>>		COROTEST_EQUAL(Compute().Get(), 42);
+ * >>> }
+ */
+namespace CoroTest
+{
+	using FTestFunction = void(*)();
+
+	struct FTestCase
+	{
+		const char* Name;
+		FTestFunction Function;
+	};
+
+	inline std::vector<FTestCase>& GetTests()
+	{
+		static std::vector<FTestCase> Tests;
+		return Tests;
+	}
+
+	inline int& GetFailureCount()
+	{
+		static int Failures = 0;
+		return Failures;
+	}
+
+	struct FRegisterTest
+	{
+		FRegisterTest(const char* Name, FTestFunction Function)
+		{
+			GetTests().push_back({Name, Function});
+		}
+	};
+
+	inline void ReportFailure(const char* File, int Line, const char* Expression)
+	{
+		std::fprintf(stderr, "%s(%d): check failed: %s\n", File, Line, Expression);
+		++GetFailureCount();
+	}
+}
+
+#define COROTEST(Name) \
+	static void CoroTest_##Name(); \
+	static CoroTest::FRegisterTest CoroTestRegister_##Name(#Name, &CoroTest_##Name); \
+	static void CoroTest_##Name()
+
+#define COROTEST_CHECK(Expr) \
+	do { if (!(Expr)) CoroTest::ReportFailure(__FILE__, __LINE__, #Expr); } while (0)
+
+#define COROTEST_EQUAL(Actual, Expected) \
+	do { if (!((Actual) == (Expected))) CoroTest::ReportFailure(__FILE__, __LINE__, #Actual " == " #Expected); } while (0)
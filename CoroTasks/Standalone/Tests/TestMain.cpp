@@ -0,0 +1,46 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstring>
+
+#include "CoroTest.h"
+
+/** Runs all registered tests, the only argument is an optional substring filter of test names */
+int main(int Argc, char** Argv)
+{
+	const char* Filter = Argc > 1 ? Argv[1] : nullptr;
+	int NumRun = 0;
+	for (const CoroTest::FTestCase& Test : CoroTest::GetTests())
+	{
+		if (Filter && !std::strstr(Test.Name, Filter))
+			continue;
+
+		const int FailuresBefore = CoroTest::GetFailureCount();
+		Test.Function();
+		std::printf("[%s] %s\n", CoroTest::GetFailureCount() == FailuresBefore ? " OK " : "FAIL", Test.Name);
+		++NumRun;
+	}
+
+	std::printf("%d tests, %d failed checks\n", NumRun, CoroTest::GetFailureCount());
+	return CoroTest::GetFailureCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroScheduler.h"
+#include "CoroTask.h"
+#include "CoroTest.h"
+
+namespace
+{
+	struct FManualAwaitable
+	{
+		CoroTasks::FContinuation Continuation;
+
+		bool await_ready()
+		{
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> Handle)
+		{
+			Continuation = CoroTasks::FContinuation::Capture(Handle, "FManualAwaitable");
+		}
+
+		void await_resume()
+		{
+		}
+	};
+
+	CoroTasks::TTask<> Task_Wait(FManualAwaitable& Awaitable, int& Counter)
+	{
+		++Counter;
+		co_await Awaitable;
+		++Counter;
+	}
+}
+
+COROTEST(Continuation_ResumesCapturedHandle)
+{
+	FManualAwaitable Awaitable;
+	int Counter = 0;
+	CoroTasks::TTask<> Task = Task_Wait(Awaitable, Counter);
+	COROTEST_CHECK(!Awaitable.Continuation.IsValid());
+
+	Task.Launch();
+	COROTEST_EQUAL(Counter, 1);
+	COROTEST_CHECK(Awaitable.Continuation.IsValid());
+
+	Awaitable.Continuation.Resume();
+	COROTEST_EQUAL(Counter, 2);
+	COROTEST_CHECK(Task.IsDone());
+}
+
+COROTEST(Continuation_RevokedIsNotResumed)
+{
+	FManualAwaitable Awaitable;
+	int Counter = 0;
+	CoroTasks::TTask<> Task = Task_Wait(Awaitable, Counter);
+	Task.Launch();
+
+	CoroTasks::FRevocableContinuation Shared(Awaitable.Continuation);
+	Shared.Revoke();
+	Shared.Resume();
+	COROTEST_EQUAL(Counter, 1);
+	COROTEST_CHECK(!Task.IsDone());
+}
+
+COROTEST(Continuation_RevocableResumesOnce)
+{
+	FManualAwaitable Awaitable;
+	int Counter = 0;
+	CoroTasks::TTask<> Task = Task_Wait(Awaitable, Counter);
+	Task.Launch();
+
+	CoroTasks::FRevocableContinuation Shared(Awaitable.Continuation);
+	Shared.Resume();
+	COROTEST_EQUAL(Counter, 2);
+	COROTEST_CHECK(Task.IsDone());
+
+	// Destructor of the awaiter revokes after the resume, it's a no-op
+	Shared.Revoke();
+	Shared.Resume();
+	COROTEST_EQUAL(Counter, 2);
+}
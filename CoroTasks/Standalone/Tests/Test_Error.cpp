@@ -0,0 +1,84 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <string>
+
+#include "CoroTask.h"
+#include "CoroTest.h"
+
+namespace
+{
+	CoroTasks::TTask<int> Task_Failing(bool bFail)
+	{
+		if (bFail)
+			CORO_FAIL(CoroTasks::FCoroError("Out of stock"));
+		co_return 10;
+	}
+
+	CoroTasks::TTask<int> Task_Forwarding(bool bFail)
+	{
+		CORO_TRY(Value, Task_Failing(bFail));
+		co_return Value * 2;
+	}
+
+	CoroTasks::TTask<> Task_Catch(bool bFail, int& OutValue, std::string& OutError)
+	{
+#if COROTASKS_WITH_EXCEPTIONS
+		try
+		{
+			OutValue = co_await Task_Forwarding(bFail);
+		}
+		catch (const CoroTasks::FCoroError& Error)
+		{
+			OutError = Error.GetMessage();
+		}
+#else
+		auto Result = co_await Task_Forwarding(bFail);
+		if (Result.HasError())
+			OutError = Result.GetError().GetMessage();
+		else
+			OutValue = Result.GetValue();
+#endif
+	}
+}
+
+COROTEST(Error_ValuePassesThroughTry)
+{
+	int Value = 0;
+	std::string Error;
+	CoroTasks::TTask<> Task = Task_Catch(false, Value, Error);
+	Task.Launch();
+	COROTEST_EQUAL(Value, 20);
+	COROTEST_CHECK(Error.empty());
+}
+
+COROTEST(Error_IsForwardedToCaller)
+{
+	int Value = 0;
+	std::string Error;
+	CoroTasks::TTask<> Task = Task_Catch(true, Value, Error);
+	Task.Launch();
+	COROTEST_EQUAL(Value, 0);
+	COROTEST_EQUAL(Error, std::string("Out of stock"));
+	COROTEST_CHECK(Task.IsDone());
+}
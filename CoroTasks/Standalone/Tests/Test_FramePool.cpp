@@ -0,0 +1,123 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstdlib>
+#include <thread>
+
+#include "CoroFramePoolCore.h"
+#include "CoroTest.h"
+
+namespace
+{
+	struct FCountingAllocator
+	{
+		static inline int NumMallocs = 0;
+		static inline int NumFrees = 0;
+		static inline thread_local std::size_t LastMallocSize = 0;
+
+		static void* Malloc(std::size_t Size)
+		{
+			++NumMallocs;
+			LastMallocSize = Size;
+			return std::malloc(Size);
+		}
+
+		static void Free(void* Ptr)
+		{
+			++NumFrees;
+			std::free(Ptr);
+		}
+	};
+
+	using FPool = CoroTasks::Core::TFramePool<FCountingAllocator>;
+}
+
+COROTEST(FramePool_ReusesFreedFrames)
+{
+	void* First = FPool::Allocate(100);
+	FPool::Free(First, 100);
+	const int MallocsBefore = FCountingAllocator::NumMallocs;
+
+	void* Second = FPool::Allocate(120);
+	COROTEST_EQUAL(Second, First);
+	COROTEST_EQUAL(FCountingAllocator::NumMallocs, MallocsBefore);
+	FPool::Free(Second, 120);
+}
+
+COROTEST(FramePool_BucketsAreSeparate)
+{
+	void* Small = FPool::Allocate(32);
+	FPool::Free(Small, 32);
+
+	void* Large = FPool::Allocate(200);
+	COROTEST_CHECK(Large != Small);
+	FPool::Free(Large, 200);
+}
+
+COROTEST(FramePool_HugeFramesBypassPool)
+{
+	const std::size_t Huge = FPool::BucketGranularity * FPool::NumBuckets + 1;
+	const int FreesBefore = FCountingAllocator::NumFrees;
+	void* Frame = FPool::Allocate(Huge);
+	FPool::Free(Frame, Huge);
+	COROTEST_EQUAL(FCountingAllocator::NumFrees, FreesBefore + 1);
+}
+
+namespace
+{
+	/** Allocates a frame from its destructor, after the pool's cache of the same thread is gone */
+	struct FLateAllocation
+	{
+		void** Frame = nullptr;
+		std::size_t* MallocSize = nullptr;
+
+		~FLateAllocation()
+		{
+			*Frame = FPool::Allocate(100);
+			*MallocSize = FCountingAllocator::LastMallocSize;
+		}
+	};
+}
+
+COROTEST(FramePool_LateFramesKeepBucketSize)
+{
+	void* Frame = nullptr;
+	std::size_t MallocSize = 0;
+	std::thread([&Frame, &MallocSize]
+	{
+		// Constructed before the cache, so destroyed after it
+		thread_local FLateAllocation Late;
+		Late.Frame = &Frame;
+		Late.MallocSize = &MallocSize;
+		FPool::Free(FPool::Allocate(100), 100);
+	}).join();
+
+	COROTEST_CHECK(Frame != nullptr);
+	COROTEST_EQUAL(MallocSize, FPool::BucketGranularity * 2);
+
+	// Pooled here and handed out for the largest size of its bucket
+	FPool::Free(Frame, 100);
+	void* Reused = FPool::Allocate(128);
+	COROTEST_EQUAL(Reused, Frame);
+	FPool::Free(Reused, 128);
+}
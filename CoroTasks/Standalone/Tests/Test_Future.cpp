@@ -0,0 +1,78 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "CoroTask.h"
+#include "CoroFuture.h"
+#include "CoroTest.h"
+
+namespace
+{
+	CoroTasks::TTask<> Task_Await(CoroTasks::TFuture<int>& Future, int& Out)
+	{
+		Out = co_await Future;
+	}
+
+	CoroTasks::TTask<> Task_AwaitVoid(CoroTasks::TFuture<void>& Future, bool& bDone)
+	{
+		co_await Future;
+		bDone = true;
+	}
+}
+
+COROTEST(Future_Ready)
+{
+	CoroTasks::TFuture<int> Future;
+	Future.SetResult(3);
+
+	int Out = 0;
+	CoroTasks::TTask<> Task = Task_Await(Future, Out);
+	Task.Launch();
+	COROTEST_EQUAL(Out, 3);
+	COROTEST_CHECK(!Future.IsResumed());
+}
+
+COROTEST(Future_ResumesOnSetResult)
+{
+	CoroTasks::TFuture<int> Future;
+	int Out = 0;
+	CoroTasks::TTask<> Task = Task_Await(Future, Out);
+	Task.Launch();
+	COROTEST_CHECK(!Task.IsDone());
+
+	Future.SetResult(9);
+	COROTEST_EQUAL(Out, 9);
+	COROTEST_CHECK(Future.IsResumed());
+	COROTEST_CHECK(Task.IsDone());
+}
+
+COROTEST(Future_Void)
+{
+	CoroTasks::TFuture<void> Future;
+	bool bDone = false;
+	CoroTasks::TTask<> Task = Task_AwaitVoid(Future, bDone);
+	Task.Launch();
+	COROTEST_CHECK(!bDone);
+
+	Future.SetResult();
+	COROTEST_CHECK(bDone);
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <vector>
+
+#include "CoroGenerator.h"
+#include "CoroTest.h"
+
+namespace
+{
+	struct FNode
+	{
+		int Value;
+		std::vector<FNode> Children;
+	};
+
+	CoroTasks::TGenerator<int> Range(int Begin, int End)
+	{
+		for (int Value = Begin; Value < End; ++Value)
+			co_yield Value;
+	}
+
+	CoroTasks::TGenerator<int> Constants()
+	{
+		const int First = 1;
+		co_yield First;
+		const int Second = 2;
+		co_yield Second;
+	}
+
+	CoroTasks::TGenerator<const FNode&> Walk(const FNode& Node)
+	{
+		co_yield Node;
+		for (const FNode& Child : Node.Children)
+			co_yield Walk(Child);
+	}
+}
+
+COROTEST(Generator_Range)
+{
+	std::vector<int> Values;
+	for (int Value : Range(0, 4))
+		Values.push_back(Value);
+	COROTEST_EQUAL(Values, (std::vector<int>{0, 1, 2, 3}));
+}
+
+COROTEST(Generator_ConstLvalueIsCopied)
+{
+	std::vector<int> Values;
+	for (int& Value : Constants())
+	{
+		Values.push_back(Value);
+		Value = 0;
+	}
+	COROTEST_EQUAL(Values, (std::vector<int>{1, 2}));
+}
+
+COROTEST(Generator_RecursiveYield)
+{
+	const FNode Root{1, {FNode{2, {FNode{3, {}}}}, FNode{4, {}}}};
+	std::vector<int> Values;
+	for (const FNode& Node : Walk(Root))
+		Values.push_back(Node.Value);
+	COROTEST_EQUAL(Values, (std::vector<int>{1, 2, 3, 4}));
+}
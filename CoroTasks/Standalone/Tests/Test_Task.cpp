@@ -0,0 +1,163 @@
+// Copyright (c) 2023, Artem Selivanov
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <vector>
+
+#include "CoroTask.h"
+#include "CoroFuture.h"
+#include "CoroTest.h"
+
+namespace
+{
+	CoroTasks::TTask<int> Task_Value(int Value)
+	{
+		co_return Value;
+	}
+
+	CoroTasks::TTask<int> Task_Sum(int A, int B)
+	{
+		CORO_TRY(First, Task_Value(A));
+		CORO_TRY(Second, Task_Value(B));
+		co_return First + Second;
+	}
+
+	CoroTasks::TTask<> Task_Store(CoroTasks::TTask<int> Task, int& Out)
+	{
+		CORO_TRY(Value, std::move(Task));
+		Out = Value;
+	}
+
+	CoroTasks::TTask<int> Task_Deep(int Depth)
+	{
+		if (Depth == 0)
+			co_return 0;
+		CORO_TRY(Value, Task_Deep(Depth - 1));
+		co_return Value + 1;
+	}
+
+	CoroTasks::TTask<> Task_WaitFuture(CoroTasks::TFuture<int>& Future, std::vector<int>& Order)
+	{
+		Order.push_back(1);
+		const int Value = co_await Future;
+		Order.push_back(Value);
+	}
+
+	struct FDestroyCounter
+	{
+		int& Count;
+		~FDestroyCounter()
+		{
+			++Count;
+		}
+	};
+
+	CoroTasks::TTask<int> Task_CountedWait(CoroTasks::TFuture<int>& Future, int& Destroyed)
+	{
+		FDestroyCounter Counter{Destroyed};
+		co_return co_await Future;
+	}
+
+	CoroTasks::TTask<> Task_CountedChain(CoroTasks::TFuture<int>& Future, int& Destroyed, int& Out)
+	{
+		FDestroyCounter Counter{Destroyed};
+		CORO_TRY(Value, Task_CountedWait(Future, Destroyed));
+		Out = Value;
+	}
+}
+
+COROTEST(Task_IsLazy)
+{
+	int Out = 0;
+	CoroTasks::TTask<> Task = Task_Store(Task_Value(7), Out);
+	COROTEST_EQUAL(Out, 0);
+	COROTEST_CHECK(!Task.IsDone());
+
+	Task.Launch();
+	COROTEST_EQUAL(Out, 7);
+	COROTEST_CHECK(Task.IsDone());
+}
+
+COROTEST(Task_AwaitChain)
+{
+	int Out = 0;
+	CoroTasks::TTask<> Task = Task_Store(Task_Sum(40, 2), Out);
+	Task.Launch();
+	COROTEST_EQUAL(Out, 42);
+}
+
+COROTEST(Task_DeepChainDoesNotGrowStack)
+{
+	// Symmetric transfer is a tail call only in optimized builds (see TTask::await_suspend)
+#ifdef __OPTIMIZE__
+	constexpr int Depth = 100000;
+#else
+	constexpr int Depth = 1000;
+#endif
+	int Out = 0;
+	CoroTasks::TTask<> Task = Task_Store(Task_Deep(Depth), Out);
+	Task.Launch();
+	COROTEST_EQUAL(Out, Depth);
+}
+
+COROTEST(Task_DetachedFinishesAndFreesItself)
+{
+	std::vector<int> Order;
+	CoroTasks::TFuture<int> Future;
+	{
+		CoroTasks::TTask<> Task = Task_WaitFuture(Future, Order);
+		Task.Launch();
+	}
+	COROTEST_EQUAL(Order, (std::vector<int>{1}));
+
+	Future.SetResult(5);
+	COROTEST_EQUAL(Order, (std::vector<int>{1, 5}));
+}
+
+COROTEST(Task_NotLaunchedIsDestroyed)
+{
+	int Out = 0;
+	{
+		CoroTasks::TTask<> Task = Task_Store(Task_Value(1), Out);
+	}
+	COROTEST_EQUAL(Out, 0);
+}
+
+COROTEST(Task_CancelDestroysAwaitedChain)
+{
+	int Destroyed = 0;
+	int Out = 0;
+	CoroTasks::TFuture<int> Future;
+	CoroTasks::TTask<> Task = Task_CountedChain(Future, Destroyed, Out);
+	Task.Launch();
+	COROTEST_EQUAL(Destroyed, 0);
+
+	Task.Cancel();
+	COROTEST_EQUAL(Destroyed, 2);
+	COROTEST_CHECK(!Task.IsValid());
+	COROTEST_EQUAL(Out, 0);
+
+	// Future forgot the destroyed frame
+	Future.SetResult(5);
+	COROTEST_CHECK(Future.IsResumed());
+	COROTEST_EQUAL(Out, 0);
+}